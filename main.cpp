@@ -4,61 +4,515 @@
 #include <limits>
 #include <array>
 #include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <memory>
+#include <chrono>
+#include <stdexcept>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+#include <algorithm>
 #include "Color.hpp"
 #include "Image.hpp"
 #include "Timer.hpp"
-#include "Ray.hpp"
-#include "Plane.hpp"
-#include "Sphere.hpp"
-#include "Light.hpp"
+#include "Metrics.hpp"
 #include "SceneLoader.hpp"
+#include "Scene.hpp"
+#include "TileRenderer.hpp"
+#include "Executor.hpp"
+#include "TaskGraph.hpp"
+#include "RenderStats.hpp"
+#include "CancellationToken.hpp"
+#include "Topology.hpp"
+#include "TraversalOrder.hpp"
+#include "Frame.hpp"
+#include "Benchmark.hpp"
+#include "Batch.hpp"
+#include "Animation.hpp"
+#include "FramePipeline.hpp"
+#include "TileCosts.hpp"
+#include "Shard.hpp"
+#include "StreamingEncoder.hpp"
+#include "RenderMetrics.hpp"
+#include "RenderCache.hpp"
+#include "PngStream.hpp"
 
 using namespace std;
 using namespace math;
 using namespace rayscene;
 
+static void PrintUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--executor serial|pool|par_unseq] [--threads N] [--affinity none|compact|scatter]"
+              << " [--order scanline|tiled|morton|hilbert] [--seed N] [--time-limit SECONDS]"
+              << " [--sched-stats] [--two-pass] [--sample-parallel] [--tile-costs]"
+              << " [--shard K/N] [--stage-times] [--ray-stats] [--metrics-file PATH [--metrics-interval SECONDS]]"
+              << " [--cache DIR [--cache-size MB]] [scene.json]\n"
+              << "       " << program << " --batch [options] scene.json... | --manifest FILE [options]\n"
+              << "       " << program << " --benchmark DIR [--repeat N] [--executor ...] [--threads N] [--affinity ...] [--two-pass] [--sample-parallel]" << endl;
+}
+
+static int ParsePositive(const char* value)
+{
+    char* end = nullptr;
+    const long parsed = std::strtol(value, &end, 10);
+    if (end == value || *end != '\0' || parsed <= 0) {
+        throw std::invalid_argument(std::string("Expected a positive integer, got: ") + value);
+    }
+    return static_cast<int>(parsed);
+}
+
 int main(int argc, char* argv[])
 {
-    srand (static_cast <unsigned> (time(0)));
+    std::string sceneFile = "../../../scene.json";
+    std::optional<unsigned> threadsOverride;
+    std::optional<rayrender::AffinityMode> affinityOverride;
+    std::optional<rayrender::TraversalOrder> orderOverride;
+    std::optional<rayrender::ExecutorKind> executorOverride;
+    std::optional<std::uint64_t> seedOverride;
+    std::optional<double> timeLimitOverride;
+    std::optional<std::string> benchmarkDirectory;
+    std::optional<std::string> manifestFile;
+    std::vector<std::string> sceneFiles;
+    bool batch = false;
+    std::optional<rayapp::ShardSpec> shard;
+    int benchmarkRepeat = 3;
+    bool printSchedulerStats = false;
+    bool useTileCosts = false;
+    bool printStageTimes = false;
+    bool printRayStats = false;
+    std::optional<std::string> metricsPath;
+    std::optional<std::string> cacheDirectory;
+    std::uint64_t cacheMegabytes = 1024;
+    std::chrono::milliseconds metricsInterval = std::chrono::seconds(5);
+    rayapp::FrameOptions frameOptions;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--threads" && hasValue) {
+                threadsOverride = static_cast<unsigned>(ParsePositive(argv[++i]));
+            } else if (arg == "--affinity" && hasValue) {
+                affinityOverride = rayrender::ParseAffinityMode(argv[++i]);
+            } else if (arg == "--executor" && hasValue) {
+                executorOverride = rayrender::ParseExecutorKind(argv[++i]);
+            } else if (arg == "--order" && hasValue) {
+                orderOverride = rayrender::ParseTraversalOrder(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                char* end = nullptr;
+                const char* value = argv[++i];
+                const unsigned long long seed = std::strtoull(value, &end, 10);
+                if (end == value || *end != '\0') {
+                    throw std::invalid_argument(std::string("Invalid seed: ") + value);
+                }
+                seedOverride = seed;
+            } else if (arg == "--time-limit" && hasValue) {
+                char* end = nullptr;
+                const char* value = argv[++i];
+                const double seconds = std::strtod(value, &end);
+                if (end == value || *end != '\0' || !(seconds > 0)) {
+                    throw std::invalid_argument(std::string("Invalid time limit: ") + value);
+                }
+                timeLimitOverride = seconds;
+            } else if (arg == "--metrics-file" && hasValue) {
+                metricsPath = argv[++i];
+            } else if (arg == "--metrics-interval" && hasValue) {
+                char* end = nullptr;
+                const char* value = argv[++i];
+                const double seconds = std::strtod(value, &end);
+                if (end == value || *end != '\0' || !(seconds > 0)) {
+                    throw std::invalid_argument(std::string("Invalid metrics interval: ") + value);
+                }
+                metricsInterval = std::chrono::milliseconds(std::max<long long>(1, static_cast<long long>(seconds * 1000.0)));
+            } else if (arg == "--cache" && hasValue) {
+                cacheDirectory = argv[++i];
+            } else if (arg == "--cache-size" && hasValue) {
+                cacheMegabytes = static_cast<std::uint64_t>(ParsePositive(argv[++i]));
+            } else if (arg == "--shard" && hasValue) {
+                shard = rayapp::ParseShard(argv[++i]);
+            } else if (arg == "--benchmark" && hasValue) {
+                benchmarkDirectory = argv[++i];
+            } else if (arg == "--batch") {
+                batch = true;
+            } else if (arg == "--manifest" && hasValue) {
+                manifestFile = argv[++i];
+            } else if (arg == "--repeat" && hasValue) {
+                benchmarkRepeat = ParsePositive(argv[++i]);
+            } else if (arg == "--two-pass") {
+                frameOptions.twoPass = true;
+            } else if (arg == "--sample-parallel") {
+                frameOptions.sampleParallel = true;
+            } else if (arg == "--tile-costs") {
+                useTileCosts = true;
+            } else if (arg == "--ray-stats") {
+                printRayStats = true;
+            } else if (arg == "--stage-times") {
+                printStageTimes = true;
+            } else if (arg == "--sched-stats") {
+                printSchedulerStats = true;
+            } else if (arg == "--help" || arg == "-h") {
+                PrintUsage(argv[0]);
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw std::invalid_argument("Unknown option: " + arg);
+            } else {
+                sceneFiles.push_back(arg);
+            }
+        }
+        batch = batch || manifestFile.has_value();
+        if (!batch && sceneFiles.size() > 1) {
+            throw std::invalid_argument("Several scene files given: use --batch");
+        }
+        if (batch && shard) {
+            throw std::invalid_argument("--shard cannot be combined with --batch");
+        }
+        if (!batch && !sceneFiles.empty()) {
+            sceneFile = sceneFiles.front();
+        }
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << endl;
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Métriques au format Prometheus, réécrites dans un fichier pendant le rendu (--metrics-file).
+    // Le fichier est déclaré après le registre : il est détruit avant, et sa dernière écriture lit un registre vivant.
+    Metrics metrics;
+    std::optional<rayapp::RenderMetrics> renderMetrics;
+    std::optional<MetricsFile> metricsFile;
+    const auto startMetrics = [&](unsigned threads) {
+        if (!metricsPath) {
+            return;
+        }
+        AddProcessMetrics(metrics, threads);
+        renderMetrics.emplace(metrics);
+        metricsFile.emplace(metrics, *metricsPath, metricsInterval);
+    };
+
+    // Cache des images déjà rendues, partagé entre processus (--cache).
+    std::optional<rayapp::RenderCache> cache;
+    if (cacheDirectory) {
+        try {
+            cache.emplace(*cacheDirectory, cacheMegabytes * 1024 * 1024);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << endl;
+            return 1;
+        }
+    }
+
+    if (benchmarkDirectory) {
+        rayrender::RenderSettings renderSettings;
+        renderSettings.threads = threadsOverride.value_or(0);
+        renderSettings.affinity = affinityOverride.value_or(rayrender::AffinityMode::None);
+        renderSettings.executor = executorOverride.value_or(rayrender::ExecutorKind::ThreadPool);
+
+        rayrender::TileRenderer renderer(renderSettings);
+        rayrender::PrintTopology(std::cout, renderer.topology(), renderSettings.affinity, renderer.workerCpus());
+        std::cout << "Executor: " << rayrender::ExecutorKindName(renderer.executorKind())
+                  << ", render threads: " << renderer.threadCount() << endl;
+        startMetrics(renderer.threadCount());
+
+        rayapp::BenchmarkOptions benchmarkOptions;
+        benchmarkOptions.sceneDirectory = *benchmarkDirectory;
+        benchmarkOptions.repeat = benchmarkRepeat;
+        benchmarkOptions.frame = frameOptions;
+        rayapp::RunBenchmark(benchmarkOptions, renderer, std::cout);
+
+        if (printSchedulerStats) {
+            rayrender::PrintWorkerStats(std::cout, renderer.schedulerStats());
+        }
+        return 0;
+    }
+
+    if (batch) {
+        rayrender::RenderSettings renderSettings;
+        renderSettings.threads = threadsOverride.value_or(0);
+        renderSettings.affinity = affinityOverride.value_or(rayrender::AffinityMode::None);
+        renderSettings.executor = executorOverride.value_or(rayrender::ExecutorKind::ThreadPool);
+
+        rayapp::BatchOptions batchOptions;
+        batchOptions.frame = frameOptions;
+        batchOptions.seed = seedOverride;
+        batchOptions.order = orderOverride;
+        batchOptions.timeLimitSeconds = timeLimitOverride;
+        batchOptions.tileCosts = useTileCosts;
+        batchOptions.cache = cache ? &*cache : nullptr;
+
+        int failures = 0;
+        try {
+            if (manifestFile) {
+                batchOptions.scenes = rayapp::ReadBatchManifest(*manifestFile);
+            }
+            batchOptions.scenes.insert(batchOptions.scenes.end(), sceneFiles.begin(), sceneFiles.end());
+
+            rayrender::TileRenderer renderer(renderSettings);
+            rayrender::PrintTopology(std::cout, renderer.topology(), renderSettings.affinity, renderer.workerCpus());
+            std::cout << "Executor: " << rayrender::ExecutorKindName(renderer.executorKind())
+                      << ", render threads: " << renderer.threadCount() << ", scenes: " << batchOptions.scenes.size() << endl;
+
+            startMetrics(renderer.threadCount());
+            batchOptions.metrics = renderMetrics ? &*renderMetrics : nullptr;
 
-    const std::string sceneFile = (argc > 1) ? argv[1] : "../../../scene.json";
+            failures = rayapp::RunBatch(batchOptions, renderer, std::cout);
 
-    SceneConfig sceneConfig = LoadSceneFromJson(sceneFile);
+            if (printSchedulerStats) {
+                rayrender::PrintWorkerStats(std::cout, renderer.schedulerStats());
+            }
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << endl;
+            return 1;
+        }
+        return failures > 0 ? 1 : 0;
+    }
+
+    // Rendu d'une scène en étapes : celles qui ne dépendent pas l'une de l'autre se chevauchent
+    // (construction de la scène pendant le démarrage des workers, sauvegarde des coûts pendant l'encodage).
+    // Le PNG est encodé ligne par ligne pendant le rendu ; l'étape encode ne fait que le terminer.
+    // Avec un bloc animation, l'étape render enchaîne les images ; chacune finit d'être encodée
+    // pendant le rendu de la suivante et l'étape encode attend la dernière.
+    SceneConfig sceneConfig;
+    std::unique_ptr<rayrender::TileRenderer> renderer;
+    std::optional<Scene> scene;
+    std::optional<Image> image;
+    std::optional<rayapp::FrameStatus> frame;
+    std::unique_ptr<rayapp::StreamingEncoder> encoder;
+    rayapp::FramePipeline framePipeline;
+    rayapp::AnimationReport animation;
+    std::optional<Timer> liveTimer;
+    rayrender::CancellationToken cancellation;
+    std::string shardPath;
+    std::string tileCostPath;
+    rayrender::StatsSnapshot statsBefore;
+    rayrender::StatsSnapshot renderStats;
+    double renderSeconds = 0.0;
+    std::string cacheKey;
+    bool cacheHit = false;
+
+    rayrender::TaskGraph pipeline;
+
+    const auto load = pipeline.add("load", [&] {
+        sceneConfig = LoadSceneFromJson(sceneFile);
+
+        if (seedOverride) {
+            sceneConfig.seed = *seedOverride;
+        }
+        if (sceneConfig.render.sampleParallel.value_or(false)) {
+            frameOptions.sampleParallel = true;
+        }
+        if (shard && frameOptions.sampleParallel) {
+            // Le mode échantillons rend toute l'image dans chaque morceau : pas de découpage en tuiles à partager.
+            throw std::runtime_error("--shard cannot be combined with sample-parallel rendering");
+        }
+        if (shard && sceneConfig.animation) {
+            throw std::runtime_error("--shard cannot be combined with an animation block");
+        }
+
+        std::cout << "Loaded scene: " << sceneFile << " (" << sceneConfig.width << "x" << sceneConfig.height << ")";
+        if (sceneConfig.animation) {
+            std::cout << ", frames " << sceneConfig.animation->firstFrame << "-" << sceneConfig.animation->lastFrame;
+        }
+        std::cout << endl;
+
+        // Image déjà en cache : copiée vers la sortie, les étapes suivantes n'ont rien à faire.
+        // Une animation passe par le cache image par image, dans RenderAnimation.
+        if (cache && !shard && !sceneConfig.animation) {
+            cacheKey = rayapp::RenderCacheKey(sceneConfig, frameOptions);
+            cacheHit = cache->fetch(cacheKey, sceneConfig.outputPath);
+        }
+    });
+
+    const auto setup = pipeline.add("setup", [&] {
+        if (cacheHit) {
+            return;
+        }
+        rayrender::RenderSettings renderSettings;
+        renderSettings.threads = threadsOverride.value_or(sceneConfig.render.threads.value_or(0));
+        renderSettings.affinity = affinityOverride.value_or(sceneConfig.render.affinity.value_or(rayrender::AffinityMode::None));
+        renderSettings.order = orderOverride.value_or(sceneConfig.render.order.value_or(rayrender::TraversalOrder::Tiled));
+        renderSettings.executor = executorOverride.value_or(sceneConfig.render.executor.value_or(rayrender::ExecutorKind::ThreadPool));
+
+        renderer = std::make_unique<rayrender::TileRenderer>(renderSettings);
+        rayrender::PrintTopology(std::cout, renderer->topology(), renderSettings.affinity, renderer->workerCpus());
+        std::cout << "Executor: " << rayrender::ExecutorKindName(renderer->executorKind())
+                  << ", render threads: " << renderer->threadCount() << ", seed: " << sceneConfig.seed << endl;
+        startMetrics(renderer->threadCount());
+        framePipeline.setMetrics(renderMetrics ? &*renderMetrics : nullptr);
+
+        useTileCosts = useTileCosts || sceneConfig.render.tileCosts.value_or(false);
+        if (shard) {
+            renderer->setShard(shard->index, shard->count);
+            shardPath = rayapp::ShardPath(sceneConfig.outputPath, *shard);
+        }
+        tileCostPath = rayapp::TileCostPath(shard ? shardPath : sceneConfig.outputPath);
+        if (useTileCosts && !sceneConfig.animation) {
+            if (auto costs = rayapp::LoadTileCosts(tileCostPath, sceneConfig.width, sceneConfig.height, renderer->settings())) {
+                std::cout << "Tile costs: " << costs->size() << " tiles from " << tileCostPath << endl;
+                renderer->setTileCostHint(std::move(*costs));
+            }
+        }
+
+        liveTimer.emplace(sceneConfig.timerLabel);
 
-    std::cout << "Loaded scene: " << sceneFile << " (" << sceneConfig.width << "x" << sceneConfig.height << ")" << endl;
+        // Avancement lu dans les compteurs par thread : sommes de relaxed loads, sans verrou.
+        statsBefore = rayrender::stats::Snapshot();
+        const std::uint64_t frameCount = sceneConfig.animation ? sceneConfig.animation->lastFrame - sceneConfig.animation->firstFrame + 1 : 1;
+        const std::uint64_t totalPixels = static_cast<std::uint64_t>(sceneConfig.width) * sceneConfig.height * frameCount;
+        liveTimer->setProgress([&, totalPixels] {
+            const rayrender::StatsSnapshot current = rayrender::stats::Snapshot() - statsBefore;
+            std::ostringstream text;
+            text << "pixels " << (totalPixels ? 100 * current.pixels / totalPixels : 0) << " %, "
+                 << std::fixed << std::setprecision(1) << current.totalRays() / 1e6 << " M rayons";
+            return text.str();
+        });
 
-    Timer liveTimer(sceneConfig.timerLabel);
+        // Le budget court depuis le démarrage du chronomètre ; l'encodage PNG vient en plus.
+        // Pour une animation, le budget vaut pour chaque image : RenderAnimation réarme le jeton.
+        // Sans budget, pas de jeton : le rendu reste en une passe.
+        const std::optional<double> timeLimit = timeLimitOverride ? timeLimitOverride : sceneConfig.render.timeLimitSeconds;
+        if (sceneConfig.animation) {
+            if (timeLimit) {
+                renderer->setCancellationToken(&cancellation);
+            }
+        } else if (timeLimit) {
+            liveTimer->setTimeLimit(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(*timeLimit)));
+            cancellation.setDeadline(liveTimer->deadline());
+            renderer->setCancellationToken(&cancellation);
+        }
+    }, {load});
 
-    Image image(sceneConfig.width, sceneConfig.height, sceneConfig.background);
+    const auto preprocess = pipeline.add("preprocess", [&] {
+        if (cacheHit) {
+            return;
+        }
+        scene.emplace(sceneConfig);
+    }, {load});
 
-    Light light = sceneConfig.light ? Light(sceneConfig.light->position) : Light(Vec3(-5.0, 1.5, 5.0));
+    const auto allocate = pipeline.add("allocate", [&] {
+        if (sceneConfig.animation || cacheHit) {
+            return;  // Une image par rendu, allouée par le FramePipeline ; ou rien à rendre
+        }
+        image.emplace(rayapp::MakeFrameImage(sceneConfig, *renderer));
+        if (!shard) {
+            // Les fichiers partiels gardent les couleurs en flottants : pas de PNG à produire.
+            const rayrender::RenderSettings& settings = renderer->settings();
+            encoder = std::make_unique<rayapp::StreamingEncoder>(*image, sceneConfig.outputPath,
+                rayrender::MakeTiles(sceneConfig.width, sceneConfig.height, settings.tileSize, settings.order));
+            renderer->setTileListener([&](const rayrender::Tile& tile) { encoder->tileDone(tile); });
+        }
+    }, {setup});
 
-    Vec3 cam_origin = sceneConfig.camera.origin;
+    const auto render = pipeline.add("render", [&] {
+        if (cacheHit) {
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const rayrender::StatsSnapshot before = rayrender::stats::Snapshot();
+        if (sceneConfig.animation) {
+            rayapp::AnimationOptions animationOptions;
+            animationOptions.frame = frameOptions;
+            animationOptions.frameTimeLimitSeconds = timeLimitOverride ? timeLimitOverride : sceneConfig.render.timeLimitSeconds;
+            animationOptions.tileCosts = useTileCosts;
+            animationOptions.cache = cache ? &*cache : nullptr;
+            rayapp::RenderAnimation(sceneConfig, *scene, *renderer, framePipeline, cancellation, animationOptions, animation, std::cout);
+            frame = rayapp::FrameStatus{animation.minSamplesPerPixel, animation.incompleteFrames == 0};
+        } else {
+            frame = rayapp::RenderFrameInto(*image, sceneConfig, *scene, *renderer, frameOptions);
+        }
+        renderStats = rayrender::stats::Snapshot() - before;
+        renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }, {preprocess, allocate});
 
-    Plane plane = sceneConfig.plane
-        ? Plane({sceneConfig.plane->primaryColor, sceneConfig.plane->secondaryColor},
-                sceneConfig.plane->posY,
-                sceneConfig.plane->tileSize)
-        : Plane({Color(1, 1, 1), Color(0, 0, 0)}, 0.0f, 1.0f);
+    const auto encodeId = pipeline.add("encode", [&] {
+        if (cacheHit) {
+            return;
+        }
+        if (sceneConfig.animation) {
+            framePipeline.wait();
+            if (!animation.error.empty()) {
+                throw std::runtime_error(animation.error);
+            }
+        } else if (shard) {
+            rayapp::WriteShard(shardPath, *image, *renderer, *shard, rayapp::RenderKeyHash(rayapp::RenderCacheKey(sceneConfig, frameOptions)));
+        } else {
+            encoder->finish();
+            renderer->setTileListener(nullptr);
+            // Un rendu interrompu par le budget n'est pas l'image de référence : pas mis en cache.
+            if (!cacheKey.empty() && frame->complete) {
+                cache->store(cacheKey, sceneConfig.outputPath);
+            }
+        }
+        liveTimer->stop();
+    }, {render});
 
-    vector<Sphere> spheres;
-    spheres.reserve(sceneConfig.spheres.size());
-    for (const auto& sphereCfg : sceneConfig.spheres) {
-        spheres.emplace_back(sphereCfg.center,
-                             sphereCfg.radius,
-                             nullptr,
-                             sphereCfg.color,
-                             sphereCfg.reflectFactor,
-                             sphereCfg.specularPower);
+    // Un rendu interrompu a des coûts partiels : on garde ceux du dernier rendu complet.
+    pipeline.add("tile-costs", [&] {
+        if (!cacheHit && useTileCosts && frame->complete && !sceneConfig.animation
+            && !rayapp::SaveTileCosts(tileCostPath, sceneConfig.width, sceneConfig.height, renderer->settings(), renderer->tileCosts())) {
+            std::cerr << "Unable to write tile costs: " << tileCostPath << endl;
+        }
+    }, {render});
+
+    try {
+        pipeline.run();
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << endl;
+        return 1;
+    }
+
+    if (renderMetrics) {
+        renderMetrics->observeStages(pipeline.timings());
+        if (!sceneConfig.animation && !shard && !cacheHit) {
+            // Image fixe : hors FramePipeline, les durées viennent des étapes du graphe.
+            const rayrender::StageTiming& encodeStage = pipeline.timings()[encodeId];
+            renderMetrics->frameRendered(renderSeconds);
+            renderMetrics->frameEncoded(encodeStage.end - encodeStage.start);
+        }
+        metricsFile->stop();
     }
 
-    plane.DrawPlane(image, cam_origin, sceneConfig.width, sceneConfig.height, spheres, light, sceneConfig.echantillonsNumber);
+    if (cacheHit) {
+        std::cout << "Cache hit: " << sceneConfig.outputPath << " copied from " << cache->directory() << endl;
+        return 0;
+    }
 
-    Sphere::DrawSphere(image, cam_origin, sceneConfig.width, sceneConfig.height, spheres, light, plane, sceneConfig.echantillonsNumber);
+    if (shard) {
+        std::cout << "Shard " << shard->index + 1 << "/" << shard->count << " written to " << shardPath << endl;
+    }
 
-    image.WriteFile(sceneConfig.outputPath.c_str());
+    if (sceneConfig.animation) {
+        std::cout << "Animation: " << animation.frames << " frames, render " << std::fixed << std::setprecision(1)
+                  << animation.renderSeconds * 1000.0 << " ms, encode " << animation.encodeSeconds * 1000.0
+                  << " ms (overlapped with rendering)" << endl;
+        if (animation.cachedFrames > 0) {
+            std::cout << "Cache: " << animation.cachedFrames << " frame(s) copied from " << cache->directory() << endl;
+        }
+        if (animation.incompleteFrames > 0) {
+            std::cout << "Time limit reached on " << animation.incompleteFrames << " frame(s), down to "
+                      << animation.minSamplesPerPixel << "/" << sceneConfig.echantillonsNumber << " samples per pixel" << endl;
+        }
+    } else if (!frame->complete) {
+        std::cout << "Time limit reached: " << frame->samplesPerPixel << "/" << sceneConfig.echantillonsNumber
+                  << " samples per pixel" << endl;
+    }
 
-    liveTimer.stop();
+    if (printSchedulerStats) {
+        rayrender::PrintWorkerStats(std::cout, renderer->schedulerStats());
+    }
+
+    if (printRayStats) {
+        rayrender::PrintRenderStats(std::cout, renderStats, renderSeconds);
+    }
+
+    if (printStageTimes) {
+        rayrender::PrintStageTimings(std::cout, pipeline.timings());
+        if (encoder) {
+            std::cout << "PNG rows encoded during render: " << encoder->rowsStreamed() << "/" << sceneConfig.height
+                      << (PngStreamWriter::Streaming() ? "" : " (no zlib: encoded after render)") << endl;
+        }
+    }
 
     return 0;
 }
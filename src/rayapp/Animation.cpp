@@ -0,0 +1,92 @@
+#include "Animation.hpp"
+
+#include "../rayscene/Keyframes.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace rayapp {
+
+void RenderAnimation(const rayscene::SceneConfig& config,
+                     rayscene::Scene& scene,
+                     rayrender::TileRenderer& renderer,
+                     FramePipeline& pipeline,
+                     rayrender::CancellationToken& cancellation,
+                     const AnimationOptions& options,
+                     AnimationReport& report,
+                     std::ostream& out) {
+    using Clock = std::chrono::steady_clock;
+
+    if (!config.animation) {
+        throw std::invalid_argument("RenderAnimation: scene has no animation block");
+    }
+    const rayscene::AnimationConfig& animation = *config.animation;
+    const int frameCount = animation.lastFrame - animation.firstFrame + 1;
+    report.minSamplesPerPixel = config.echantillonsNumber;
+
+    renderer.resetTileCosts();
+    for (int frame = animation.firstFrame; frame <= animation.lastFrame; ++frame) {
+        const rayscene::SceneConfig frameConfig = rayscene::FrameConfig(config, frame);
+        std::string cacheKey;
+        if (options.cache) {
+            cacheKey = RenderCacheKey(frameConfig, options.frame);
+            if (options.cache->fetch(cacheKey, frameConfig.outputPath)) {
+                ++report.frames;
+                ++report.cachedFrames;
+                out << "Frame " << frame << " (" << report.frames << "/" << frameCount << ") -> "
+                    << frameConfig.outputPath << " (cached)\n" << std::flush;
+                continue;
+            }
+        }
+        scene.applyFrame(frameConfig);
+
+        const Clock::time_point start = Clock::now();
+        if (options.frameTimeLimitSeconds) {
+            cancellation.setDeadline(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(*options.frameTimeLimitSeconds)));
+        }
+
+        Image& image = pipeline.begin(frameConfig, renderer);
+        FrameStatus status{};
+        try {
+            status = RenderFrameInto(image, frameConfig, scene, renderer, options.frame);
+        } catch (...) {
+            pipeline.abandon(renderer);
+            throw;
+        }
+        RenderCache* cache = status.complete ? options.cache : nullptr;
+        pipeline.end(renderer, [&report, cache, cacheKey, path = frameConfig.outputPath](double seconds, std::exception_ptr error) {
+            report.encodeSeconds += seconds;
+            if (cache && !error) {
+                cache->store(cacheKey, path);
+            }
+            if (error && report.error.empty()) {
+                try {
+                    std::rethrow_exception(error);
+                } catch (const std::exception& e) {
+                    report.error = e.what();
+                }
+            }
+        });
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Les images successives se ressemblent : les coûts de celle-ci ordonnent la suivante.
+        if (options.tileCosts && status.complete) {
+            renderer.setTileCostHint(renderer.tileCosts());
+        }
+        renderer.resetTileCosts();
+
+        ++report.frames;
+        report.renderSeconds += seconds;
+        report.minSamplesPerPixel = std::min(report.minSamplesPerPixel, status.samplesPerPixel);
+        if (!status.complete) ++report.incompleteFrames;
+
+        out << "Frame " << frame << " (" << report.frames << "/" << frameCount << ") -> " << frameConfig.outputPath
+            << " (" << std::fixed << std::setprecision(1) << seconds * 1000.0 << " ms"
+            << (status.complete ? "" : ", time limit") << ")\n" << std::flush;
+    }
+}
+
+} // namespace rayapp
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "FramePipeline.hpp"
+#include "RenderCache.hpp"
+
+#include "../rayrender/CancellationToken.hpp"
+
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+namespace rayapp {
+
+struct AnimationOptions {
+    FrameOptions frame;
+    std::optional<double> frameTimeLimitSeconds;  // Budget de chaque image
+    bool tileCosts = false;  // Les coûts de tuiles d'une image ordonnent les tuiles de la suivante
+    RenderCache* cache = nullptr;  // Images déjà rendues reprises du cache, images complètes ajoutées
+};
+
+// Rempli au fil des images ; les temps d'encodage arrivent par les rappels du pipeline,
+// le rapport doit donc vivre jusqu'à pipeline.wait().
+struct AnimationReport {
+    int frames = 0;
+    int incompleteFrames = 0;       // Interrompues par le budget de temps
+    int cachedFrames = 0;           // Reprises du cache, sans rendu
+    int minSamplesPerPixel = 0;
+    double renderSeconds = 0.0;
+    double encodeSeconds = 0.0;
+    std::string error;              // Première erreur d'encodage
+};
+
+// Rend les images firstFrame..lastFrame du bloc animation de config dans pipeline :
+// l'image N finit d'être encodée pendant le rendu de N+1. scene doit avoir été construite
+// depuis config ; elle est mise à jour en place à chaque image (Scene::applyFrame).
+// cancellation est le jeton du renderer : avec frameTimeLimitSeconds, son échéance est réarmée
+// pour chaque image ; sans, il n'est pas touché (un cancel() reste valable pour toute l'animation).
+void RenderAnimation(const rayscene::SceneConfig& config,
+                     rayscene::Scene& scene,
+                     rayrender::TileRenderer& renderer,
+                     FramePipeline& pipeline,
+                     rayrender::CancellationToken& cancellation,
+                     const AnimationOptions& options,
+                     AnimationReport& report,
+                     std::ostream& out);
+
+} // namespace rayapp
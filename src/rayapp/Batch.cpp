@@ -0,0 +1,295 @@
+#include "Batch.hpp"
+#include "Animation.hpp"
+#include "FramePipeline.hpp"
+#include "TileCosts.hpp"
+
+#include "../rayrender/CancellationToken.hpp"
+
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace rayapp {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Scène chargée et construite en avance ; l'adresse de config reste stable pour Scene.
+struct LoadedScene {
+    rayscene::SceneConfig config;
+    std::unique_ptr<rayscene::Scene> scene;
+    double seconds = 0.0;
+};
+
+struct JobReport {
+    std::string scene;
+    int width = 0;
+    int height = 0;
+    int frames = 1;
+    int samplesPerPixel = 0;
+    int requestedSamples = 0;
+    double loadSeconds = 0.0;
+    double renderSeconds = 0.0;
+    double encodeSeconds = 0.0;
+    bool complete = false;
+    bool cached = false;
+    std::string error;
+};
+
+std::unique_ptr<LoadedScene> loadScene(const std::string& path, const BatchOptions& options) {
+    const Clock::time_point start = Clock::now();
+    auto loaded = std::make_unique<LoadedScene>();
+    loaded->config = rayscene::LoadSceneFromJson(path);
+    if (options.seed) {
+        loaded->config.seed = *options.seed;
+    }
+    loaded->scene = std::make_unique<rayscene::Scene>(loaded->config);
+    loaded->seconds = secondsSince(start);
+    return loaded;
+}
+
+std::future<std::unique_ptr<LoadedScene>> prefetch(const std::string& path, const BatchOptions& options) {
+    return std::async(std::launch::async, [path, &options] { return loadScene(path, options); });
+}
+
+std::string describe(std::exception_ptr error) {
+    try {
+        std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+        return e.what();
+    } catch (...) {
+        return "unknown error";
+    }
+}
+
+void printSummary(std::ostream& out, const std::vector<JobReport>& reports, double wallSeconds) {
+    out << std::left << std::setw(32) << "scene" << std::setw(11) << "size"
+        << std::right << std::setw(9) << "spp" << std::setw(10) << "load ms"
+        << std::setw(11) << "render ms" << std::setw(11) << "encode ms" << "  status\n";
+
+    double load = 0.0;
+    double render = 0.0;
+    double encode = 0.0;
+    for (const JobReport& report : reports) {
+        std::ostringstream size;
+        size << report.width << "x" << report.height;
+        if (report.frames > 1) size << "x" << report.frames;
+        std::ostringstream samples;
+        samples << report.samplesPerPixel << "/" << report.requestedSamples;
+
+        out << std::left << std::setw(32) << report.scene << std::setw(11) << size.str()
+            << std::right << std::setw(9) << samples.str()
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << report.loadSeconds * 1000.0
+            << std::setw(11) << report.renderSeconds * 1000.0
+            << std::setw(11) << report.encodeSeconds * 1000.0 << "  "
+            << (!report.error.empty() ? "error: " + report.error : report.cached ? "cached" : report.complete ? "ok" : "time limit") << "\n";
+        load += report.loadSeconds;
+        render += report.renderSeconds;
+        encode += report.encodeSeconds;
+    }
+
+    // Chargement et encodage recouvrent les rendus : le total mural est inférieur à la somme.
+    out << std::left << std::setw(52) << "total"
+        << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << load * 1000.0 << std::setw(11) << render * 1000.0 << std::setw(11) << encode * 1000.0
+        << "  wall " << wallSeconds * 1000.0 << " ms\n";
+}
+
+} // namespace
+
+std::vector<std::string> ReadBatchManifest(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Unable to read manifest: " + path);
+    }
+
+    const std::filesystem::path base = std::filesystem::path(path).parent_path();
+    std::vector<std::string> scenes;
+    std::string line;
+    while (std::getline(input, line)) {
+        line = line.substr(0, line.find('#'));
+        const std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+        const std::size_t last = line.find_last_not_of(" \t\r");
+        const std::filesystem::path scene = line.substr(first, last - first + 1);
+        scenes.push_back((scene.is_absolute() ? scene : base / scene).string());
+    }
+    return scenes;
+}
+
+int RunBatch(const BatchOptions& options, rayrender::TileRenderer& renderer, std::ostream& out) {
+    if (options.scenes.empty()) {
+        throw std::runtime_error("Batch: no scene files");
+    }
+
+    const Clock::time_point batchStart = Clock::now();
+    const rayrender::TraversalOrder initialOrder = renderer.settings().order;
+    rayrender::CancellationToken cancellation;
+
+    std::vector<JobReport> reports(options.scenes.size());
+    std::vector<std::pair<std::size_t, std::shared_ptr<AnimationReport>>> animations;
+    FramePipeline pipeline;
+    pipeline.setMetrics(options.metrics);
+    MetricValue* queueDepth = options.metrics
+        ? &options.metrics->registry().gauge("hetic_queue_depth", "Jobs waiting to be rendered.")
+        : nullptr;
+    std::future<std::unique_ptr<LoadedScene>> next = prefetch(options.scenes[0], options);
+
+    for (std::size_t job = 0; job < options.scenes.size(); ++job) {
+        JobReport& report = reports[job];
+        report.scene = std::filesystem::path(options.scenes[job]).filename().string();
+        if (queueDepth) {
+            queueDepth->set(static_cast<double>(options.scenes.size() - job - 1));
+        }
+
+        try {
+            std::unique_ptr<LoadedScene> loaded = next.get();
+            if (job + 1 < options.scenes.size()) {
+                next = prefetch(options.scenes[job + 1], options);
+            }
+            const rayscene::SceneConfig& config = loaded->config;
+            report.width = config.width;
+            report.height = config.height;
+            report.requestedSamples = config.echantillonsNumber;
+            report.loadSeconds = loaded->seconds;
+            if (options.metrics) {
+                options.metrics->observeStage("load", loaded->seconds);
+            }
+
+            FrameOptions frameOptions = options.frame;
+            frameOptions.sampleParallel = frameOptions.sampleParallel || config.render.sampleParallel.value_or(false);
+            renderer.setTraversalOrder(options.order.value_or(config.render.order.value_or(rayrender::TraversalOrder::Tiled)));
+
+            renderer.resetTileCosts();
+            renderer.setTileCostHint({});
+            const bool useTileCosts = options.tileCosts || config.render.tileCosts.value_or(false);
+            const std::optional<double> timeLimit = options.timeLimitSeconds ? options.timeLimitSeconds : config.render.timeLimitSeconds;
+            // Sans budget, pas de jeton : le rendu reste en une passe au lieu de passer en progressif.
+            renderer.setCancellationToken(timeLimit ? &cancellation : nullptr);
+
+            if (config.animation) {
+                // Les images d'une animation passent par le même pipeline que les scènes du batch.
+                AnimationOptions animationOptions;
+                animationOptions.frame = frameOptions;
+                animationOptions.frameTimeLimitSeconds = timeLimit;
+                animationOptions.tileCosts = useTileCosts;
+                animationOptions.cache = options.cache;
+                auto animation = std::make_shared<AnimationReport>();
+                RenderAnimation(config, *loaded->scene, renderer, pipeline, cancellation, animationOptions, *animation, out);
+                // Les derniers encodages se terminent pendant le job suivant : le rapport est complété à la fin.
+                animations.emplace_back(job, animation);
+                report.frames = animation->frames;
+                report.samplesPerPixel = animation->minSamplesPerPixel;
+                report.renderSeconds = animation->renderSeconds;
+                report.complete = animation->incompleteFrames == 0;
+                report.cached = animation->cachedFrames == animation->frames;
+                continue;
+            }
+
+            std::string cacheKey;
+            if (options.cache) {
+                cacheKey = RenderCacheKey(config, frameOptions);
+                if (options.cache->fetch(cacheKey, config.outputPath)) {
+                    report.samplesPerPixel = config.echantillonsNumber;
+                    report.complete = true;
+                    report.cached = true;
+                    out << "[" << job + 1 << "/" << options.scenes.size() << "] " << options.scenes[job]
+                        << " -> " << config.outputPath << " (cached)\n" << std::flush;
+                    continue;
+                }
+            }
+
+            const std::string tileCostPath = TileCostPath(config.outputPath);
+            if (useTileCosts) {
+                if (auto costs = LoadTileCosts(tileCostPath, config.width, config.height, renderer.settings())) {
+                    renderer.setTileCostHint(std::move(*costs));
+                }
+            }
+
+            const Clock::time_point start = Clock::now();
+            cancellation.reset();
+            if (timeLimit) {
+                cancellation.setDeadline(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(*timeLimit)));
+            }
+
+            Image& image = pipeline.begin(config, renderer);
+            FrameStatus status{};
+            try {
+                status = RenderFrameInto(image, config, *loaded->scene, renderer, frameOptions);
+            } catch (...) {
+                pipeline.abandon(renderer);
+                throw;
+            }
+            RenderCache* cache = status.complete ? options.cache : nullptr;
+            pipeline.end(renderer, [&report, cache, cacheKey, path = config.outputPath](double seconds, std::exception_ptr error) {
+                report.encodeSeconds = seconds;
+                if (error) {
+                    report.error = describe(error);
+                } else if (cache) {
+                    cache->store(cacheKey, path);
+                }
+            });
+            report.renderSeconds = secondsSince(start);
+            report.samplesPerPixel = status.samplesPerPixel;
+            report.complete = status.complete;
+
+            if (useTileCosts && status.complete
+                && !SaveTileCosts(tileCostPath, config.width, config.height, renderer.settings(), renderer.tileCosts())) {
+                out << "Unable to write tile costs: " << tileCostPath << "\n";
+            }
+
+            out << "[" << job + 1 << "/" << options.scenes.size() << "] " << options.scenes[job]
+                << " -> " << config.outputPath << " (" << config.width << "x" << config.height << ", "
+                << std::fixed << std::setprecision(1) << report.renderSeconds * 1000.0 << " ms)\n" << std::flush;
+        } catch (const std::exception& error) {
+            report.error = error.what();
+            out << "[" << job + 1 << "/" << options.scenes.size() << "] " << options.scenes[job]
+                << ": " << error.what() << "\n" << std::flush;
+            if (job + 1 < options.scenes.size() && !next.valid()) {
+                next = prefetch(options.scenes[job + 1], options);
+            }
+        }
+    }
+
+    pipeline.wait();
+    for (const auto& [job, animation] : animations) {
+        reports[job].encodeSeconds = animation->encodeSeconds;
+        if (!animation->error.empty() && reports[job].error.empty()) {
+            reports[job].error = animation->error;
+        }
+    }
+    renderer.setCancellationToken(nullptr);
+    renderer.setTraversalOrder(initialOrder);
+
+    out << "\n";
+    printSummary(out, reports, secondsSince(batchStart));
+    if (options.cache) {
+        out << "Cache " << options.cache->directory() << ": " << options.cache->hits() << " hit(s), "
+            << options.cache->misses() << " miss(es)\n";
+    }
+
+    int failures = 0;
+    for (const JobReport& report : reports) {
+        if (!report.error.empty()) ++failures;
+    }
+    return failures;
+}
+
+} // namespace rayapp
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Frame.hpp"
+#include "RenderCache.hpp"
+#include "RenderMetrics.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rayapp {
+
+struct BatchOptions {
+    std::vector<std::string> scenes;
+    FrameOptions frame;
+    // Surcharges de la ligne de commande, appliquées à chaque scène.
+    std::optional<std::uint64_t> seed;
+    std::optional<rayrender::TraversalOrder> order;
+    std::optional<double> timeLimitSeconds;
+    bool tileCosts = false;
+    RenderMetrics* metrics = nullptr;  // Durées par étape et par image, scènes restantes
+    RenderCache* cache = nullptr;      // Scènes déjà rendues copiées depuis le cache
+};
+
+// Lit un manifeste : un fichier de scène par ligne, '#' commence un commentaire.
+// Les chemins relatifs sont résolus depuis le dossier du manifeste.
+std::vector<std::string> ReadBatchManifest(const std::string& path);
+
+// Rend les scènes l'une après l'autre avec le même renderer (donc les mêmes workers).
+// La scène suivante est chargée et construite pendant le rendu, et la fin de l'encodage
+// d'une image se fait pendant le rendu de la suivante ; deux encodeurs servent à tour de rôle,
+// avec leurs tampons (FramePipeline). Une scène animée rend toutes ses images dans le même pipeline.
+// Les réglages threads/affinity/executor des scènes sont ignorés.
+// Affiche une ligne par scène puis un récapitulatif des temps. Retourne le nombre d'échecs.
+int RunBatch(const BatchOptions& options, rayrender::TileRenderer& renderer, std::ostream& out);
+
+} // namespace rayapp
@@ -0,0 +1,72 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace rayapp {
+
+namespace {
+
+std::vector<std::filesystem::path> listScenes(const std::string& directory) {
+    std::vector<std::filesystem::path> scenes;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            scenes.push_back(entry.path());
+        }
+    }
+    std::sort(scenes.begin(), scenes.end());
+    return scenes;
+}
+
+} // namespace
+
+int RunBenchmark(const BenchmarkOptions& options, rayrender::TileRenderer& renderer, std::ostream& out) {
+    using Clock = std::chrono::steady_clock;
+
+    const std::vector<std::filesystem::path> scenes = listScenes(options.sceneDirectory);
+    if (scenes.empty()) {
+        throw std::runtime_error("No scene files in " + options.sceneDirectory);
+    }
+
+    const rayrender::TraversalOrder initialOrder = renderer.settings().order;
+    const int repeat = std::max(1, options.repeat);
+
+    out << std::left << std::setw(32) << "scene" << std::setw(10) << "order"
+        << std::right << std::setw(12) << "ms/frame" << std::setw(14) << "Mrays/s" << "\n";
+
+    for (const auto& path : scenes) {
+        const rayscene::SceneConfig config = rayscene::LoadSceneFromJson(path.string());
+        const rayscene::Scene scene(config);
+        const double primaryRays = double(config.width) * double(config.height) * double(config.echantillonsNumber);
+
+        for (const rayrender::TraversalOrder order : rayrender::AllTraversalOrders) {
+            renderer.setTraversalOrder(order);
+
+            std::vector<double> timings;
+            timings.reserve(repeat);
+            for (int run = 0; run < repeat; ++run) {
+                const Clock::time_point start = Clock::now();
+                RenderFrame(config, scene, renderer, options.frame);
+                timings.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+            }
+            std::sort(timings.begin(), timings.end());
+            const double seconds = timings[timings.size() / 2];
+
+            out << std::left << std::setw(32) << path.filename().string()
+                << std::setw(10) << rayrender::TraversalOrderName(order)
+                << std::right << std::fixed << std::setprecision(1) << std::setw(12) << seconds * 1000.0
+                << std::setprecision(2) << std::setw(14) << (seconds > 0 ? primaryRays / seconds / 1e6 : 0.0)
+                << "\n" << std::flush;
+        }
+    }
+
+    renderer.setTraversalOrder(initialOrder);
+    return static_cast<int>(scenes.size());
+}
+
+} // namespace rayapp
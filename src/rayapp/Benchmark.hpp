@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Frame.hpp"
+
+#include <iosfwd>
+#include <string>
+
+namespace rayapp {
+
+struct BenchmarkOptions {
+    std::string sceneDirectory = "scenes";
+    int repeat = 3;         // Rendus par couple (scène, ordre) ; on garde la médiane
+    FrameOptions frame;
+};
+
+// Rend chaque *.json du dossier avec chaque ordre de parcours et affiche,
+// pour chaque couple, les ms par image et les rayons primaires par seconde.
+// Rien n'est écrit sur disque. Retourne le nombre de scènes rendues.
+int RunBenchmark(const BenchmarkOptions& options, rayrender::TileRenderer& renderer, std::ostream& out);
+
+} // namespace rayapp
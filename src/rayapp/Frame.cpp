@@ -0,0 +1,48 @@
+#include "Frame.hpp"
+
+#include "../rayscene/Camera.hpp"
+#include "../rayscene/Integrator.hpp"
+
+#include <utility>
+
+namespace rayapp {
+
+using namespace rayscene;
+
+Image MakeFrameImage(const SceneConfig& config, rayrender::TileRenderer& renderer) {
+    return Image(config.width, config.height, config.background, [&](const Image::RegionInit& initRegion) {
+        renderer.firstTouch(config.width, config.height, [&](const rayrender::Tile& tile) {
+            initRegion(tile.x0, tile.y0, tile.x1, tile.y1);
+        });
+    });
+}
+
+RenderedFrame RenderFrame(const SceneConfig& config, const Scene& scene, rayrender::TileRenderer& renderer, const FrameOptions& options) {
+    Image image = MakeFrameImage(config, renderer);
+    const FrameStatus status = RenderFrameInto(image, config, scene, renderer, options);
+    return RenderedFrame{std::move(image), status};
+}
+
+FrameStatus RenderFrameInto(Image& image, const SceneConfig& config, const Scene& scene, rayrender::TileRenderer& renderer, const FrameOptions& options) {
+    int samplesPerPixel = config.echantillonsNumber;
+    if (options.twoPass) {
+        scene.plane().DrawPlane(image, renderer, scene.cameraOrigin(), config.width, config.height, scene.sphereBvh(), scene.light(), config.echantillonsNumber, config.seed);
+
+        Sphere::DrawSphere(image, renderer, scene.cameraOrigin(), config.width, config.height, scene.sphereBvh(), scene.light(), scene.plane(), config.echantillonsNumber, config.seed);
+
+        if (renderer.isCancelled()) {
+            samplesPerPixel = 0;  // Des tuiles ont pu être sautées
+        }
+    } else {
+        const Camera camera(scene.cameraOrigin(), config.width, config.height);
+        const Integrator integrator(scene.sphereBvh(), scene.plane(), scene.light(), config.background);
+        samplesPerPixel = options.sampleParallel
+            ? integrator.RenderSampleParallel(image, renderer, camera, config.echantillonsNumber, config.seed)
+            : integrator.Render(image, renderer, camera, config.echantillonsNumber, config.seed);
+    }
+
+    const bool complete = samplesPerPixel >= config.echantillonsNumber;
+    return FrameStatus{samplesPerPixel, complete};
+}
+
+} // namespace rayapp
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../rayimage/Image.hpp"
+#include "../rayrender/TileRenderer.hpp"
+#include "../rayscene/Scene.hpp"
+#include "../rayscene/SceneLoader.hpp"
+
+namespace rayapp {
+
+struct FrameOptions {
+    bool twoPass = false;         // Ancien rendu Plane::DrawPlane puis Sphere::DrawSphere
+    bool sampleParallel = false;  // Parallélise les échantillons plutôt que les tuiles (petites images)
+};
+
+struct FrameStatus {
+    int samplesPerPixel;  // Échantillons du pixel le moins bien servi
+    bool complete;        // false si le jeton d'annulation a interrompu le rendu
+};
+
+struct RenderedFrame {
+    Image image;
+    FrameStatus status;
+};
+
+// Image au fond de la scène, chaque tuile étant initialisée par le worker qui la rendra.
+Image MakeFrameImage(const rayscene::SceneConfig& config, rayrender::TileRenderer& renderer);
+
+// Rend la scène dans image (créée par MakeFrameImage), sans l'écrire sur disque.
+// L'image reste en place : un encodeur peut lire les lignes terminées pendant le rendu.
+FrameStatus RenderFrameInto(Image& image,
+                            const rayscene::SceneConfig& config,
+                            const rayscene::Scene& scene,
+                            rayrender::TileRenderer& renderer,
+                            const FrameOptions& options);
+
+// MakeFrameImage puis RenderFrameInto.
+RenderedFrame RenderFrame(const rayscene::SceneConfig& config,
+                  const rayscene::Scene& scene,
+                  rayrender::TileRenderer& renderer,
+                  const FrameOptions& options);
+
+} // namespace rayapp
@@ -0,0 +1,116 @@
+#include "FramePipeline.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace rayapp {
+
+FramePipeline::~FramePipeline() {
+    for (Slot& slot : m_slots) {
+        if (slot.finishing.valid()) slot.finishing.wait();
+    }
+}
+
+Image& FramePipeline::begin(const rayscene::SceneConfig& config, rayrender::TileRenderer& renderer) {
+    if (m_current) {
+        throw std::logic_error("FramePipeline: begin() without end()");
+    }
+
+    Slot& slot = m_slots[m_next];
+    Slot& other = m_slots[1 - m_next];
+    drain(slot);
+    // Deux rendus vers le même fichier : le second attend que le premier soit écrit.
+    if (other.finishing.valid() && other.outputPath == config.outputPath) {
+        drain(other);
+    }
+
+    slot.image.emplace(MakeFrameImage(config, renderer));
+    slot.outputPath = config.outputPath;
+    const rayrender::RenderSettings& settings = renderer.settings();
+    try {
+        slot.encoder->start(*slot.image, config.outputPath,
+            rayrender::MakeTiles(config.width, config.height, settings.tileSize, settings.order));
+    } catch (...) {
+        slot.image.reset();
+        throw;
+    }
+
+    StreamingEncoder& encoder = *slot.encoder;
+    renderer.setTileListener([&encoder](const rayrender::Tile& tile) { encoder.tileDone(tile); });
+    m_current = &slot;
+    m_next = 1 - m_next;
+    m_begun = std::chrono::steady_clock::now();
+    return *slot.image;
+}
+
+void FramePipeline::end(rayrender::TileRenderer& renderer, EncodedCallback onEncoded) {
+    renderer.setTileListener(nullptr);
+    if (!m_current) {
+        return;
+    }
+    Slot& slot = *m_current;
+    m_current = nullptr;
+
+    slot.onEncoded = std::move(onEncoded);
+    StreamingEncoder& encoder = *slot.encoder;
+    const auto rendered = std::chrono::steady_clock::now();
+    if (m_metrics) {
+        m_metrics->frameRendered(std::chrono::duration<double>(rendered - m_begun).count());
+    }
+    slot.finishing = std::async(std::launch::async, [&encoder, rendered] {
+        encoder.finish();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - rendered).count();
+    });
+}
+
+void FramePipeline::abandon(rayrender::TileRenderer& renderer) {
+    renderer.setTileListener(nullptr);
+    if (!m_current) {
+        return;
+    }
+    // Le destructeur arrête le thread d'encodage avant que l'image ne disparaisse.
+    m_current->encoder = std::make_unique<StreamingEncoder>();
+    m_current->image.reset();
+    m_current = nullptr;
+}
+
+void FramePipeline::wait() {
+    // Dans l'ordre des rendus : le slot le plus ancien est celui du prochain begin().
+    drain(m_slots[m_next]);
+    drain(m_slots[1 - m_next]);
+}
+
+void FramePipeline::setMetrics(RenderMetrics* metrics) noexcept {
+    m_metrics = metrics;
+}
+
+void FramePipeline::drain(Slot& slot) {
+    if (!slot.finishing.valid()) {
+        return;
+    }
+    double seconds = 0.0;
+    std::exception_ptr error;
+    try {
+        seconds = slot.finishing.get();
+    } catch (...) {
+        error = std::current_exception();
+        // Le fichier est resté ouvert : l'encodeur n'est plus réutilisable.
+        slot.encoder = std::make_unique<StreamingEncoder>();
+    }
+    slot.image.reset();
+    if (m_metrics) {
+        if (error) {
+            m_metrics->frameFailed();
+        } else {
+            m_metrics->frameEncoded(seconds);
+        }
+    }
+    if (slot.onEncoded) {
+        EncodedCallback onEncoded = std::move(slot.onEncoded);
+        slot.onEncoded = nullptr;
+        onEncoded(seconds, error);
+    }
+}
+
+} // namespace rayapp
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Frame.hpp"
+#include "RenderMetrics.hpp"
+#include "StreamingEncoder.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace rayapp {
+
+// Enchaînement de rendus vers des PNG : l'encodage d'une image se termine pendant le rendu
+// de la suivante. Deux encodeurs servent à tour de rôle, avec leur image ; un encodeur est
+// réutilisé (tampons, état zlib) dès que l'image d'il y a deux rendus est écrite.
+class FramePipeline {
+public:
+    // Appelé par begin() ou wait(), sur le thread appelant, quand l'encodage d'une image est fini.
+    // error est nul si le fichier a été écrit.
+    using EncodedCallback = std::function<void(double encodeSeconds, std::exception_ptr error)>;
+
+    FramePipeline() = default;
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Prépare le rendu suivant : image au fond de la scène (MakeFrameImage) et encodeur
+    // branché sur les tuiles de la passe finale du renderer.
+    Image& begin(const rayscene::SceneConfig& config, rayrender::TileRenderer& renderer);
+
+    // Rendu terminé : débranche l'encodeur et termine l'encodage en arrière-plan.
+    void end(rayrender::TileRenderer& renderer, EncodedCallback onEncoded);
+
+    // Rendu en échec : l'image en cours est abandonnée sans être écrite.
+    void abandon(rayrender::TileRenderer& renderer);
+
+    // Attend la fin de tous les encodages en cours.
+    void wait();
+
+    // Durées de rendu et d'encodage, images écrites ou perdues ; nullptr pour ne rien mesurer.
+    void setMetrics(RenderMetrics* metrics) noexcept;
+
+private:
+    struct Slot {
+        std::unique_ptr<StreamingEncoder> encoder = std::make_unique<StreamingEncoder>();
+        std::optional<Image> image;
+        std::string outputPath;
+        std::future<double> finishing;
+        EncodedCallback onEncoded;
+    };
+
+    void drain(Slot& slot);
+
+    std::array<Slot, 2> m_slots;
+    std::size_t m_next = 0;         // Slot du prochain begin()
+    Slot* m_current = nullptr;      // Slot entre begin() et end()
+    std::chrono::steady_clock::time_point m_begun;
+    RenderMetrics* m_metrics = nullptr;
+};
+
+} // namespace rayapp
@@ -0,0 +1,288 @@
+#include "RenderCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace rayapp {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* Magic = "hetic-render-cache";
+constexpr const char* TemporaryExtension = ".part";
+// Fichier temporaire plus vieux que ça : écrit par un processus mort en cours de route.
+constexpr auto StaleTemporaryAge = std::chrono::hours(1);
+
+void writeVec3(std::ostream& out, const math::Vec3& v) {
+    out << ' ' << v.x << ' ' << v.y << ' ' << v.z;
+}
+
+void writeColor(std::ostream& out, Color color) {
+    out << ' ' << color.R() << ' ' << color.G() << ' ' << color.B();
+}
+
+// Nom de fichier seulement, la clé complète est vérifiée à la lecture.
+std::string fingerprint(const std::string& key) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(RenderKeyHash(key)));
+    return text;
+}
+
+// Verrou exclusif sur <dossier>/lock, relâché à la destruction (ou à la mort du processus).
+class DirectoryLock {
+public:
+    explicit DirectoryLock(const std::string& directory)
+        : m_fd(::open((directory + "/lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600)) {
+        if (m_fd >= 0 && ::flock(m_fd, LOCK_EX) < 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+    ~DirectoryLock() {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    DirectoryLock(const DirectoryLock&) = delete;
+    DirectoryLock& operator=(const DirectoryLock&) = delete;
+
+    bool locked() const noexcept { return m_fd >= 0; }
+
+private:
+    int m_fd;
+};
+
+} // namespace
+
+std::string RenderCacheKey(const rayscene::SceneConfig& config, const FrameOptions& options) {
+    std::ostringstream key;
+    key << std::hexfloat;
+    key << Magic << ' ' << RendererRevision << '\n';
+    key << "size " << config.width << ' ' << config.height << '\n';
+    key << "background";
+    writeColor(key, config.background);
+    key << "\ncamera";
+    writeVec3(key, config.camera.origin);
+    writeVec3(key, config.camera.lookAt);
+    writeVec3(key, config.camera.up);
+    key << ' ' << config.camera.verticalFov << ' ' << config.camera.focusDistance << '\n';
+    if (config.plane) {
+        key << "plane";
+        writeColor(key, config.plane->primaryColor);
+        writeColor(key, config.plane->secondaryColor);
+        key << ' ' << config.plane->posY << ' ' << config.plane->tileSize << '\n';
+    } else {
+        key << "plane none\n";
+    }
+    if (config.light) {
+        key << "light";
+        writeVec3(key, config.light->position);
+        key << '\n';
+    } else {
+        key << "light none\n";
+    }
+    key << "spheres " << config.spheres.size() << '\n';
+    for (const rayscene::SphereConfig& sphere : config.spheres) {
+        key << "sphere";
+        writeVec3(key, sphere.center);
+        key << ' ' << sphere.radius;
+        writeVec3(key, sphere.color);
+        key << ' ' << sphere.reflectFactor << ' ' << sphere.specularPower << '\n';
+    }
+    key << "samples " << config.echantillonsNumber << '\n';
+    key << "seed " << config.seed << '\n';
+    key << "two-pass " << options.twoPass << '\n';
+    key << "sample-parallel " << (options.sampleParallel || config.render.sampleParallel.value_or(false)) << '\n';
+    return key.str();
+}
+
+std::uint64_t RenderKeyHash(const std::string& key) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+RenderCache::RenderCache(std::string directory, std::uint64_t maxBytes)
+    : m_directory(std::move(directory))
+    , m_maxBytes(maxBytes) {
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+    if (error || !fs::is_directory(m_directory)) {
+        throw std::runtime_error("Unable to create cache directory: " + m_directory);
+    }
+}
+
+std::string RenderCache::entryPath(const std::string& key, const char* extension) const {
+    return m_directory + "/" + fingerprint(key) + extension;
+}
+
+bool RenderCache::matches(const std::string& key) const {
+    std::ifstream input(entryPath(key, ".key"), std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    const std::string stored((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    return stored == key;
+}
+
+void RenderCache::touch(const std::string& path) {
+    std::error_code error;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+}
+
+bool RenderCache::fetch(const std::string& key, const std::string& outputPath) {
+    const std::string png = entryPath(key, ".png");
+    std::error_code error;
+    // Une éviction peut retirer l'entrée entre les deux : la copie échoue, c'est un défaut de cache.
+    if (!matches(key) || !fs::copy_file(png, outputPath, fs::copy_options::overwrite_existing, error) || error) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    touch(png);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool RenderCache::fetch(const std::string& key, std::vector<unsigned char>& png) {
+    const std::string path = entryPath(key, ".png");
+    std::ifstream input;
+    if (matches(key)) {
+        input.open(path, std::ios::binary);
+    }
+    if (!input.is_open()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    png.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    touch(path);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::string RenderCache::temporaryPath() const {
+    static std::atomic<std::uint64_t> counter{0};
+    return m_directory + "/tmp-" + std::to_string(::getpid()) + "-"
+        + std::to_string(counter.fetch_add(1, std::memory_order_relaxed)) + TemporaryExtension;
+}
+
+void RenderCache::store(const std::string& key, const std::string& pngPath) {
+    const std::string temporary = temporaryPath();
+    std::error_code error;
+    if (!fs::copy_file(pngPath, temporary, fs::copy_options::overwrite_existing, error) || error) {
+        fs::remove(temporary, error);
+        return;
+    }
+    commit(key, temporary);
+}
+
+void RenderCache::store(const std::string& key, const std::vector<unsigned char>& png) {
+    const std::string temporary = temporaryPath();
+    {
+        std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+        if (!output.flush()) {
+            std::error_code error;
+            fs::remove(temporary, error);
+            return;
+        }
+    }
+    commit(key, temporary);
+}
+
+bool RenderCache::commit(const std::string& key, const std::string& temporaryPng) {
+    // La clé d'abord : un lecteur ne voit le PNG qu'une fois sa clé en place.
+    const std::string temporaryKey = temporaryPath();
+    std::error_code error;
+    {
+        std::ofstream output(temporaryKey, std::ios::binary | std::ios::trunc);
+        output << key;
+        if (!output.flush()) {
+            fs::remove(temporaryKey, error);
+            fs::remove(temporaryPng, error);
+            return false;
+        }
+    }
+    fs::rename(temporaryKey, entryPath(key, ".key"), error);
+    if (!error) {
+        fs::rename(temporaryPng, entryPath(key, ".png"), error);
+    }
+    if (error) {
+        fs::remove(temporaryKey, error);
+        fs::remove(temporaryPng, error);
+        return false;
+    }
+    evict();
+    return true;
+}
+
+void RenderCache::evict() {
+    DirectoryLock lock(m_directory);
+    if (!lock.locked()) {
+        return;
+    }
+
+    struct Entry {
+        fs::file_time_type used;
+        fs::path png;
+        std::uint64_t bytes;
+    };
+    std::vector<Entry> entries;
+    std::uint64_t total = 0;
+    const fs::file_time_type now = fs::file_time_type::clock::now();
+    std::error_code error;
+    for (fs::directory_iterator it(m_directory, error), end; !error && it != end; it.increment(error)) {
+        const fs::path& path = it->path();
+        const fs::file_time_type modified = fs::last_write_time(path, error);
+        if (error) {
+            error.clear();
+            continue;  // Retiré entre-temps par un autre processus
+        }
+        if (path.extension() == TemporaryExtension) {
+            if (now - modified > StaleTemporaryAge) {
+                fs::remove(path, error);
+                error.clear();
+            }
+            continue;
+        }
+        if (path.extension() != ".png") {
+            continue;
+        }
+        const std::uint64_t bytes = fs::file_size(path, error);
+        if (error) {
+            error.clear();
+            continue;
+        }
+        entries.push_back(Entry{modified, path, bytes});
+        total += bytes;
+    }
+
+    if (total <= m_maxBytes) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& entry : entries) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        fs::path key = entry.png;
+        key.replace_extension(".key");
+        fs::remove(entry.png, error);
+        fs::remove(key, error);
+        total -= entry.bytes;
+    }
+}
+
+} // namespace rayapp
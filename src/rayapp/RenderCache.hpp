@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Frame.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rayapp {
+
+// À incrémenter à chaque changement qui modifie les pixels produits pour une même scène :
+// les entrées du cache écrites par une version antérieure ne sont alors plus trouvées.
+constexpr int RendererRevision = 3;
+
+// Description canonique de tout ce qui détermine les pixels d'une image fixe : révision du
+// renderer, taille, fond, caméra, plan, lumière, sphères, échantillons, graine, et les options
+// qui changent le résultat (--two-pass, rendu par échantillons). Les flottants sont écrits en
+// hexadécimal (exacts). Le chemin de sortie, les réglages d'exécution (threads, affinité,
+// ordre de parcours) et la limite de temps n'y figurent pas : ils ne changent pas l'image.
+std::string RenderCacheKey(const rayscene::SceneConfig& config, const FrameOptions& options);
+
+// Empreinte FNV-1a 64 bits d'une clé : nom des entrées du cache, en-tête des shards.
+std::uint64_t RenderKeyHash(const std::string& key);
+
+// Cache de PNG adressé par contenu : <dossier>/<empreinte de la clé>.png, avec la clé complète
+// à côté (.key) pour écarter une collision d'empreinte.
+// Plusieurs processus peuvent s'en servir à la fois : chaque fichier est écrit sous un nom
+// temporaire unique puis renommé (rename() est atomique), une lecture qui perd la course contre
+// une éviction est un simple défaut de cache, et l'éviction se fait sous flock().
+// Éviction LRU : une entrée lue est « touchée » (date de modification), les plus anciennes
+// partent dès que la taille totale dépasse maxBytes.
+class RenderCache {
+public:
+    RenderCache(std::string directory, std::uint64_t maxBytes);
+
+    const std::string& directory() const noexcept { return m_directory; }
+
+    // Copie l'image en cache vers outputPath ; false si elle n'y est pas.
+    bool fetch(const std::string& key, const std::string& outputPath);
+    // Variante sans fichier de sortie (réponse PNG du démon).
+    bool fetch(const std::string& key, std::vector<unsigned char>& png);
+
+    // Ajoute un PNG déjà écrit (copié) ou en mémoire, puis évince si besoin. Sans effet en cas
+    // d'erreur d'écriture : le cache ne fait jamais échouer un rendu.
+    void store(const std::string& key, const std::string& pngPath);
+    void store(const std::string& key, const std::vector<unsigned char>& png);
+
+    std::uint64_t hits() const noexcept { return m_hits.load(std::memory_order_relaxed); }
+    std::uint64_t misses() const noexcept { return m_misses.load(std::memory_order_relaxed); }
+
+private:
+    std::string entryPath(const std::string& key, const char* extension) const;
+    bool matches(const std::string& key) const;
+    void touch(const std::string& path);
+    bool commit(const std::string& key, const std::string& temporaryPng);
+    std::string temporaryPath() const;
+    void evict();
+
+    std::string m_directory;
+    std::uint64_t m_maxBytes;
+    std::atomic<std::uint64_t> m_hits{0};
+    std::atomic<std::uint64_t> m_misses{0};
+};
+
+} // namespace rayapp
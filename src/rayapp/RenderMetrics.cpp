@@ -0,0 +1,81 @@
+#include "RenderMetrics.hpp"
+
+#include "../rayrender/RenderStats.hpp"
+
+#include <chrono>
+#include <memory>
+
+namespace rayapp {
+
+namespace {
+
+const char* const StageHelp = "Duration of rendering stages (load, render, encode...), in seconds.";
+
+} // namespace
+
+RenderMetrics::RenderMetrics(Metrics& metrics)
+    : m_metrics(metrics)
+    , m_framesWritten(metrics.counter("hetic_frames_written_total", "Frames rendered and written to disk."))
+    , m_framesFailed(metrics.counter("hetic_frames_failed_total", "Frames whose PNG could not be written."))
+    , m_frameRender(metrics.histogram("hetic_frame_seconds", "Per-frame duration, in seconds.", "phase=\"render\""))
+    , m_frameEncode(metrics.histogram("hetic_frame_seconds", "Per-frame duration, in seconds.", "phase=\"encode\"")) {
+    using Clock = std::chrono::steady_clock;
+    static const char* const kinds[rayrender::RayKindCount] = {"primary", "shadow", "reflection"};
+    MetricValue* rays[rayrender::RayKindCount];
+    for (std::size_t kind = 0; kind < rayrender::RayKindCount; ++kind) {
+        rays[kind] = &metrics.counter("hetic_rays_total", "Rays traced, by kind.", std::string("kind=\"") + kinds[kind] + "\"");
+    }
+    MetricValue& pixels = metrics.counter("hetic_pixels_total", "Pixels whose final value was written.");
+    MetricValue& intersections = metrics.counter("hetic_intersection_tests_total", "Ray-object intersection tests.");
+    MetricValue& raysPerSecond = metrics.gauge("hetic_rays_per_second", "Rays traced per second since the previous scrape.");
+
+    // Débit entre deux écritures : dernier instantané gardé par le collecteur.
+    struct Previous {
+        Clock::time_point time = Clock::now();
+        std::uint64_t rays = rayrender::stats::Snapshot().totalRays();
+    };
+    auto previous = std::make_shared<Previous>();
+    metrics.addCollector([previous, rays, &pixels, &intersections, &raysPerSecond] {
+        const rayrender::StatsSnapshot snapshot = rayrender::stats::Snapshot();
+        for (std::size_t kind = 0; kind < rayrender::RayKindCount; ++kind) {
+            rays[kind]->set(static_cast<double>(snapshot.rays[kind]));
+        }
+        pixels.set(static_cast<double>(snapshot.pixels));
+        intersections.set(static_cast<double>(snapshot.sphereTests + snapshot.planeTests));
+
+        const Clock::time_point now = Clock::now();
+        const double seconds = std::chrono::duration<double>(now - previous->time).count();
+        if (seconds > 0.0) {
+            raysPerSecond.set(static_cast<double>(snapshot.totalRays() - previous->rays) / seconds);
+        }
+        previous->time = now;
+        previous->rays = snapshot.totalRays();
+    });
+}
+
+void RenderMetrics::frameRendered(double seconds) noexcept {
+    m_frameRender.observe(seconds);
+}
+
+void RenderMetrics::frameEncoded(double seconds) noexcept {
+    m_frameEncode.observe(seconds);
+    m_framesWritten.add(1);
+}
+
+void RenderMetrics::frameFailed() noexcept {
+    m_framesFailed.add(1);
+}
+
+void RenderMetrics::observeStage(const std::string& stage, double seconds) {
+    m_metrics.histogram("hetic_stage_seconds", StageHelp, "stage=\"" + stage + "\"").observe(seconds);
+}
+
+void RenderMetrics::observeStages(const std::vector<rayrender::StageTiming>& timings) {
+    for (const rayrender::StageTiming& timing : timings) {
+        if (timing.ran) {
+            observeStage(timing.name, timing.end - timing.start);
+        }
+    }
+}
+
+} // namespace rayapp
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../rayrender/TaskGraph.hpp"
+#include "../raytimer/Metrics.hpp"
+
+#include <string>
+#include <vector>
+
+namespace rayapp {
+
+// Métriques communes aux rendus de longue durée (batch, animation, démon), dans un registre Metrics :
+// - hetic_frames_written_total / hetic_frames_failed_total : images écrites ou perdues (FramePipeline) ;
+// - hetic_frame_seconds{phase="render"|"encode"} : durée par image ;
+// - hetic_stage_seconds{stage="..."} : durée des étapes (chargement, rendu, encodage...) ;
+// - hetic_rays_total{kind}, hetic_rays_per_second, hetic_pixels_total : compteurs par thread sommés à l'écriture.
+class RenderMetrics {
+public:
+    explicit RenderMetrics(Metrics& metrics);
+
+    Metrics& registry() noexcept { return m_metrics; }
+
+    void frameRendered(double seconds) noexcept;
+    void frameEncoded(double seconds) noexcept;
+    void frameFailed() noexcept;
+
+    void observeStage(const std::string& stage, double seconds);
+    // Une observation par étape lancée d'un TaskGraph.
+    void observeStages(const std::vector<rayrender::StageTiming>& timings);
+
+private:
+    Metrics& m_metrics;
+    MetricValue& m_framesWritten;
+    MetricValue& m_framesFailed;
+    Histogram& m_frameRender;
+    Histogram& m_frameEncode;
+};
+
+} // namespace rayapp
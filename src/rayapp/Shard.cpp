@@ -0,0 +1,191 @@
+#include "Shard.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace rayapp {
+
+namespace {
+
+constexpr char Magic[4] = {'H', 'S', 'H', 'D'};
+constexpr std::uint32_t Version = 2;
+
+struct ShardHeader {
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t index;
+    std::uint32_t count;
+    std::uint32_t tileCount;
+    std::uint64_t renderHash;  // RenderKeyHash de la scène et des options
+};
+
+struct TileRect {
+    std::uint32_t x0, y0, x1, y1;
+};
+
+unsigned parseUnsigned(const std::string& text, const std::string& spec) {
+    char* end = nullptr;
+    const unsigned long value = std::strtoul(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        throw std::invalid_argument("Invalid shard: " + spec + " (expected k/n)");
+    }
+    return static_cast<unsigned>(value);
+}
+
+template <typename T>
+void readExact(std::ifstream& input, T& value, const std::string& path) {
+    if (!input.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Truncated shard file: " + path);
+    }
+}
+
+} // namespace
+
+ShardSpec ParseShard(const std::string& text) {
+    const std::size_t slash = text.find('/');
+    if (slash == std::string::npos) {
+        throw std::invalid_argument("Invalid shard: " + text + " (expected k/n)");
+    }
+    const unsigned k = parseUnsigned(text.substr(0, slash), text);
+    const unsigned n = parseUnsigned(text.substr(slash + 1), text);
+    if (n == 0 || k == 0 || k > n) {
+        throw std::invalid_argument("Invalid shard: " + text + " (expected 1 <= k <= n)");
+    }
+    return ShardSpec{k - 1, n};
+}
+
+std::string ShardPath(const std::string& outputPath, const ShardSpec& shard) {
+    return outputPath + ".shard-" + std::to_string(shard.index + 1) + "-of-" + std::to_string(shard.count);
+}
+
+void WriteShard(const std::string& path, Image& image, const rayrender::TileRenderer& renderer, const ShardSpec& shard,
+                std::uint64_t renderHash) {
+    const int width = static_cast<int>(image.Width());
+    const int height = static_cast<int>(image.Height());
+
+    std::vector<TileRect> rects;
+    for (const rayrender::Tile& tile : rayrender::MakeTiles(width, height, renderer.settings().tileSize, renderer.settings().order)) {
+        if (renderer.ownsTile(tile.index)) {
+            rects.push_back(TileRect{std::uint32_t(tile.x0), std::uint32_t(tile.y0), std::uint32_t(tile.x1), std::uint32_t(tile.y1)});
+        }
+    }
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        throw std::runtime_error("Unable to write shard file: " + path);
+    }
+
+    const ShardHeader header{Version, std::uint32_t(width), std::uint32_t(height), shard.index, shard.count, std::uint32_t(rects.size()), renderHash};
+    output.write(Magic, sizeof(Magic));
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(rects.data()), static_cast<std::streamsize>(rects.size() * sizeof(TileRect)));
+
+    std::vector<float> row;
+    for (const TileRect& rect : rects) {
+        for (std::uint32_t y = rect.y0; y < rect.y1; ++y) {
+            row.clear();
+            for (std::uint32_t x = rect.x0; x < rect.x1; ++x) {
+                Color pixel = image.GetPixel(x, y);
+                row.push_back(pixel.R());
+                row.push_back(pixel.G());
+                row.push_back(pixel.B());
+            }
+            output.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size() * sizeof(float)));
+        }
+    }
+
+    if (!output) {
+        throw std::runtime_error("Unable to write shard file: " + path);
+    }
+}
+
+Image MergeShards(const std::vector<std::string>& paths) {
+    if (paths.empty()) {
+        throw std::runtime_error("No shard files to merge");
+    }
+
+    ShardHeader first{};
+    std::vector<bool> seenShards;
+    std::vector<bool> covered;
+    Image image(0, 0);
+
+    for (const std::string& path : paths) {
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("Unable to open shard file: " + path);
+        }
+
+        char magic[sizeof(Magic)];
+        ShardHeader header{};
+        readExact(input, magic, path);
+        readExact(input, header, path);
+        if (std::string(magic, sizeof(magic)) != std::string(Magic, sizeof(Magic)) || header.version != Version) {
+            throw std::runtime_error("Not a shard file: " + path);
+        }
+        if (header.count == 0 || header.index >= header.count) {
+            throw std::runtime_error("Invalid shard index in " + path);
+        }
+
+        if (seenShards.empty()) {
+            first = header;
+            seenShards.assign(header.count, false);
+            covered.assign(std::size_t(header.width) * header.height, false);
+            image = Image(header.width, header.height);
+        } else if (header.width != first.width || header.height != first.height || header.count != first.count) {
+            throw std::runtime_error("Shard " + path + " comes from a different render ("
+                                     + std::to_string(header.width) + "x" + std::to_string(header.height)
+                                     + ", " + std::to_string(header.count) + " shards)");
+        } else if (header.renderHash != first.renderHash) {
+            throw std::runtime_error("Shard " + path + " comes from a different render (scene or options differ)");
+        }
+        if (seenShards[header.index]) {
+            throw std::runtime_error("Shard " + std::to_string(header.index + 1) + "/" + std::to_string(header.count) + " given twice");
+        }
+        seenShards[header.index] = true;
+
+        // Une tuile couvre au moins un pixel : borne tileCount avant d'allouer.
+        if (header.tileCount > std::uint64_t(header.width) * header.height) {
+            throw std::runtime_error("Invalid tile count in shard file: " + path);
+        }
+        std::vector<TileRect> rects(header.tileCount);
+        for (TileRect& rect : rects) {
+            readExact(input, rect, path);
+            if (rect.x0 >= rect.x1 || rect.y0 >= rect.y1 || rect.x1 > header.width || rect.y1 > header.height) {
+                throw std::runtime_error("Invalid tile in shard file: " + path);
+            }
+        }
+
+        for (const TileRect& rect : rects) {
+            for (std::uint32_t y = rect.y0; y < rect.y1; ++y) {
+                for (std::uint32_t x = rect.x0; x < rect.x1; ++x) {
+                    float rgb[3];
+                    readExact(input, rgb, path);
+                    image.SetPixel(x, y, Color(rgb[0], rgb[1], rgb[2]));
+                    covered[std::size_t(y) * header.width + x] = true;
+                }
+            }
+        }
+    }
+
+    std::string missing;
+    for (std::size_t index = 0; index < seenShards.size(); ++index) {
+        if (!seenShards[index]) {
+            missing += (missing.empty() ? "" : ", ") + std::to_string(index + 1) + "/" + std::to_string(first.count);
+        }
+    }
+    if (!missing.empty()) {
+        throw std::runtime_error("Missing shards: " + missing);
+    }
+    for (bool pixel : covered) {
+        if (!pixel) {
+            throw std::runtime_error("Shards do not cover the whole image");
+        }
+    }
+
+    return image;
+}
+
+} // namespace rayapp
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../rayimage/Image.hpp"
+#include "../rayrender/TileRenderer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rayapp {
+
+// Part k d'un rendu découpé en count processus ; index est compté à partir de 0.
+struct ShardSpec {
+    unsigned index = 0;
+    unsigned count = 1;
+};
+
+// "k/n" avec 1 <= k <= n (numérotation de la ligne de commande). Lève std::invalid_argument.
+ShardSpec ParseShard(const std::string& text);
+
+// <output>.shard-k-of-n, avec k compté à partir de 1 comme sur la ligne de commande.
+std::string ShardPath(const std::string& outputPath, const ShardSpec& shard);
+
+// Écrit les tuiles possédées par le shard du renderer : en-tête, rectangles, puis les
+// couleurs en flottants (la fusion donne ainsi exactement le PNG d'un rendu en un processus).
+// renderHash identifie le rendu (RenderKeyHash de sa RenderCacheKey) : la fusion refuse les
+// shards de scènes ou d'options différentes. Lève std::runtime_error si le fichier ne peut pas être écrit.
+void WriteShard(const std::string& path, Image& image, const rayrender::TileRenderer& renderer, const ShardSpec& shard,
+                std::uint64_t renderHash);
+
+// Assemble des fichiers partiels dans une image. Tous doivent venir du même rendu et du même
+// découpage, chaque shard doit être présent une seule fois et tous les pixels couverts ; sinon
+// std::runtime_error, dont le message nomme les shards manquants à relancer.
+Image MergeShards(const std::vector<std::string>& paths);
+
+} // namespace rayapp
@@ -0,0 +1,155 @@
+#include "StreamingEncoder.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace rayapp {
+
+namespace {
+
+// Capacité de la file des lignes terminées ; les workers attendent si l'encodeur prend du retard.
+constexpr std::size_t RowRingCapacity = 256;
+
+} // namespace
+
+StreamingEncoder::StreamingEncoder()
+    : m_ring(RowRingCapacity) {
+}
+
+StreamingEncoder::StreamingEncoder(const Image& image, const std::string& path, const std::vector<rayrender::Tile>& tiles)
+    : StreamingEncoder() {
+    start(image, path, tiles);
+}
+
+void StreamingEncoder::start(const Image& image, const std::string& path, const std::vector<rayrender::Tile>& tiles) {
+    if (m_thread.joinable()) {
+        throw std::logic_error("StreamingEncoder: previous image is not finished");
+    }
+    m_writer.Open(path, image.Width(), image.Height());
+    m_image = &image;
+    m_finishing = false;
+    m_abort = false;
+    m_rowsStreamed = 0;
+    m_error = nullptr;
+
+    // Après finish(), des index peuvent rester dans la file : ils appartiennent à l'image précédente.
+    while (m_ring.tryPop()) {
+    }
+    if (m_tilesLeftCapacity < image.Height()) {
+        m_tilesLeft = std::make_unique<std::atomic<int>[]>(image.Height());
+        m_tilesLeftCapacity = image.Height();
+    }
+    for (unsigned y = 0; y < image.Height(); ++y) {
+        m_tilesLeft[y].store(0, std::memory_order_relaxed);
+    }
+    for (const rayrender::Tile& tile : tiles) {
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            m_tilesLeft[y].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    m_thread = std::thread([this] { encoderLoop(); });
+}
+
+StreamingEncoder::~StreamingEncoder() {
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_abort = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+}
+
+void StreamingEncoder::tileDone(const rayrender::Tile& tile) {
+    bool pushed = false;
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        // acq_rel : les écritures des autres tuiles de la ligne sont visibles par l'encodeur.
+        if (m_tilesLeft[y].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            while (!m_ring.tryPush(static_cast<std::size_t>(y))) {
+                std::this_thread::yield();
+            }
+            pushed = true;
+        }
+    }
+    if (pushed) {
+        // Prendre le verrou avant de réveiller : l'encodeur ne peut pas manquer la notification.
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_wake.notify_one();
+    }
+}
+
+void StreamingEncoder::finish() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finishing = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+std::size_t StreamingEncoder::rowsStreamed() const noexcept {
+    return m_rowsStreamed;
+}
+
+void StreamingEncoder::encoderLoop() {
+    const Image& image = *m_image;
+    const std::size_t height = image.Height();
+    std::vector<bool>& ready = m_ready;
+    ready.assign(height, false);
+    std::vector<unsigned char>& row = m_row;
+    row.resize(static_cast<std::size_t>(image.Width()) * 4);
+    std::size_t next = 0;
+    bool finishingSeen = false;
+
+    try {
+        while (next < height) {
+            while (auto y = m_ring.tryPop()) {
+                ready[*y] = true;
+            }
+            // Les lignes arrivent dans le désordre ; le PNG les veut de haut en bas.
+            if (ready[next]) {
+                image.ToRGBA(row.data(), static_cast<unsigned>(next), static_cast<unsigned>(next + 1));
+                m_writer.WriteRow(row.data());
+                ++next;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_abort) {
+                return;
+            }
+            if (m_finishing) {
+                // Le rendu est terminé : toutes les lignes sont définitives.
+                if (!finishingSeen) {
+                    m_rowsStreamed = next;
+                    finishingSeen = true;
+                }
+                std::fill(ready.begin(), ready.end(), true);
+                continue;
+            }
+            if (auto y = m_ring.tryPop()) {
+                ready[*y] = true;
+                continue;
+            }
+            m_wake.wait(lock);
+        }
+
+        if (!finishingSeen) {
+            m_rowsStreamed = height;
+        }
+        m_writer.Finish();
+    } catch (...) {
+        m_error = std::current_exception();
+    }
+}
+
+} // namespace rayapp
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../rayimage/Image.hpp"
+#include "../rayimage/PngStream.hpp"
+#include "../rayrender/RowRing.hpp"
+#include "../rayrender/TileRenderer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rayapp {
+
+// Encode le PNG pendant le rendu. Chaque ligne compte les tuiles qui la couvrent ; quand la
+// dernière est signalée par tileDone(), le worker pousse l'index de la ligne dans une file
+// bornée et un thread dédié convertit, filtre et compresse les lignes dans l'ordre dès qu'elles
+// se suivent. À la fin du rendu il ne reste que les dernières lignes et la fin du flux deflate.
+// Après finish(), start() réutilise l'encodeur (compteurs, tampons de lignes, état zlib)
+// pour une autre image : c'est ce que fait le mode batch.
+class StreamingEncoder {
+public:
+    StreamingEncoder();
+    // tiles : découpage de la passe finale (même taille et ordre que le renderer).
+    StreamingEncoder(const Image& image, const std::string& path, const std::vector<rayrender::Tile>& tiles);
+    ~StreamingEncoder();
+
+    // Commence l'encodage d'une nouvelle image. L'image précédente doit être terminée par finish().
+    void start(const Image& image, const std::string& path, const std::vector<rayrender::Tile>& tiles);
+
+    StreamingEncoder(const StreamingEncoder&) = delete;
+    StreamingEncoder& operator=(const StreamingEncoder&) = delete;
+
+    // Appelé par les workers, une fois par tuile de la passe finale.
+    void tileDone(const rayrender::Tile& tile);
+
+    // Fin du rendu : encode les lignes restantes (y compris celles de tuiles annulées),
+    // termine le fichier et relance l'éventuelle erreur du thread d'encodage.
+    void finish();
+
+    // Lignes déjà encodées quand finish() a été appelé (height si tout était déjà encodé).
+    std::size_t rowsStreamed() const noexcept;
+
+private:
+    void encoderLoop();
+
+    const Image* m_image = nullptr;
+    PngStreamWriter m_writer;
+    std::unique_ptr<std::atomic<int>[]> m_tilesLeft;  // Tuiles restantes par ligne
+    std::size_t m_tilesLeftCapacity = 0;
+    rayrender::RowRing m_ring;
+    std::vector<bool> m_ready;          // Lignes terminées, pas encore encodées
+    std::vector<unsigned char> m_row;   // Ligne convertie en RGBA
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_finishing = false;
+    bool m_abort = false;
+    std::size_t m_rowsStreamed = 0;
+    std::exception_ptr m_error;
+    std::thread m_thread;
+};
+
+} // namespace rayapp
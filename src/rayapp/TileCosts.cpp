@@ -0,0 +1,65 @@
+#include "TileCosts.hpp"
+
+#include <fstream>
+
+namespace rayapp {
+
+namespace {
+
+constexpr const char* Magic = "hetic-tilecost";
+constexpr int Version = 1;
+
+} // namespace
+
+std::string TileCostPath(const std::string& outputPath) {
+    return outputPath + ".tilecost";
+}
+
+std::optional<std::vector<double>> LoadTileCosts(const std::string& path, int width, int height,
+                                                 const rayrender::RenderSettings& settings) {
+    std::ifstream input(path);
+    if (!input) {
+        return std::nullopt;
+    }
+
+    std::string magic;
+    std::string order;
+    int version = 0;
+    int fileWidth = 0;
+    int fileHeight = 0;
+    int tileSize = 0;
+    std::size_t count = 0;
+    if (!(input >> magic >> version >> fileWidth >> fileHeight >> tileSize >> order >> count)
+        || magic != Magic || version != Version
+        || fileWidth != width || fileHeight != height || tileSize != settings.tileSize
+        || order != rayrender::TraversalOrderName(settings.order)
+        || count != rayrender::MakeTiles(width, height, settings.tileSize, settings.order).size()) {
+        return std::nullopt;
+    }
+
+    std::vector<double> costs(count);
+    for (double& cost : costs) {
+        if (!(input >> cost) || cost < 0) {
+            return std::nullopt;
+        }
+    }
+    return costs;
+}
+
+bool SaveTileCosts(const std::string& path, int width, int height,
+                   const rayrender::RenderSettings& settings, const std::vector<double>& costs) {
+    std::ofstream output(path, std::ios::trunc);
+    if (!output) {
+        return false;
+    }
+
+    output << Magic << ' ' << Version << ' ' << width << ' ' << height << ' ' << settings.tileSize
+           << ' ' << rayrender::TraversalOrderName(settings.order) << ' ' << costs.size() << '\n';
+    output.precision(9);
+    for (double cost : costs) {
+        output << cost << '\n';
+    }
+    return static_cast<bool>(output);
+}
+
+} // namespace rayapp
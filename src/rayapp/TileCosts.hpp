@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../rayrender/TileRenderer.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace rayapp {
+
+// Fichier compagnon de l'image rendue : temps de rendu de chaque tuile, relu au rendu suivant
+// pour distribuer les tuiles les plus chères en premier.
+// Format texte : une ligne d'en-tête (découpage) puis un temps en secondes par tuile.
+std::string TileCostPath(const std::string& outputPath);
+
+// nullopt si le fichier n'existe pas, est illisible ou correspond à un autre découpage
+// (taille d'image, taille ou ordre des tuiles).
+std::optional<std::vector<double>> LoadTileCosts(const std::string& path, int width, int height,
+                                                 const rayrender::RenderSettings& settings);
+
+// Retourne false si le fichier n'a pas pu être écrit.
+bool SaveTileCosts(const std::string& path, int width, int height,
+                   const rayrender::RenderSettings& settings, const std::vector<double>& costs);
+
+} // namespace rayapp
@@ -1,60 +1,116 @@
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include "Image.hpp"
 #include "../lodepng/lodepng.h"
 
 
+void Image::BufferDeleter::operator()(Color* pixels) const noexcept {
+  for (std::size_t i = 0; i < count; ++i) {
+    pixels[i].~Color();
+  }
+  ::operator delete(pixels);
+}
+
+void Image::Allocate() {
+  const std::size_t count = static_cast<std::size_t>(width) * height;
+  Color* pixels = static_cast<Color*>(::operator new(count * sizeof(Color)));
+  buffer = std::unique_ptr<Color[], BufferDeleter>(pixels, BufferDeleter(count));
+}
+
+void Image::FillRegion(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, Color c) {
+  for (unsigned int y = y0; y < y1 && y < height; ++y) {
+    for (unsigned int x = x0; x < x1 && x < width; ++x) {
+      new (&buffer[static_cast<std::size_t>(y) * width + x]) Color(c);
+    }
+  }
+}
+
 Image:: Image(unsigned int w, unsigned int h) : width(w), height(h)
 {  
-  buffer.resize(width * height);
-  for (int i = 0; i < buffer.size(); ++i) {
-    buffer[i] = Color();
-  }
+  Allocate();
+  FillRegion(0, 0, width, height, Color());
 }
 
 Image:: Image(unsigned int w, unsigned int h, Color c) : width(w), height(h)
 {  
-  buffer.resize(width * height);
-  for (int i = 0; i < buffer.size(); ++i) {
-    buffer[i] = c;
-  }
+  Allocate();
+  FillRegion(0, 0, width, height, c);
+}
+
+Image:: Image(unsigned int w, unsigned int h, Color c, const ParallelInit& parallelInit) : width(w), height(h)
+{
+  Allocate();
+  parallelInit([this, c](unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1) {
+    FillRegion(x0, y0, x1, y1, c);
+  });
 }
 
 Image::~ Image()
 {
 }
 
+unsigned int Image::Width() const {
+  return width;
+}
+
+unsigned int Image::Height() const {
+  return height;
+}
+
 void Image::SetPixel(unsigned int x, unsigned int y, Color color) {
   unsigned int index = (y * width) + x;
 
-  if (index >= buffer.size()) { throw std::invalid_argument("Image: Invalid index"); }
+  if (x >= width || y >= height) { throw std::invalid_argument("Image: Invalid index"); }
   buffer[index] = color;
 }
 
 Color Image::GetPixel(unsigned int x, unsigned int y) {
   unsigned int index = (y * width) + x;
 
-  if (index >= buffer.size()) { throw std::invalid_argument("Image: Invalid index"); }
+  if (x >= width || y >= height) { throw std::invalid_argument("Image: Invalid index"); }
   return buffer[index];
 }
 
 
-void Image::WriteFile(const char * filename) {
-  std::vector<unsigned char> image;
-  image.resize(width * height * 4);
-  for(unsigned index = 0; index < buffer.size(); index++) {
+void Image::ToRGBA(unsigned char* rgba, unsigned int y0, unsigned int y1) const {
+  for(unsigned index = y0 * width; index < std::min(y1, height) * width; index++) {
     Color pixel = buffer[index];
-    int offset = index * 4;
+    std::size_t offset = static_cast<std::size_t>(index - y0 * width) * 4;
 
-    image[offset] = (unsigned int)floor(pixel.R() * 255); 
-    image[offset + 1] = (unsigned int)floor(pixel.G() * 255); 
-    image[offset + 2] = (unsigned int)floor(pixel.B() * 255); 
-    image[offset + 3] = 255;      // Alpha
+    rgba[offset] = (unsigned int)floor(pixel.R() * 255); 
+    rgba[offset + 1] = (unsigned int)floor(pixel.G() * 255); 
+    rgba[offset + 2] = (unsigned int)floor(pixel.B() * 255); 
+    rgba[offset + 3] = 255;      // Alpha
   }
+}
 
+void Image::WritePNG(const char* filename, const std::vector<unsigned char>& rgba, unsigned int w, unsigned int h) {
   //Encode the image
-  unsigned error = lodepng::encode(filename, image, width, height);
+  unsigned error = lodepng::encode(filename, rgba, w, h);
 
   //if there's an error, display it
   if(error) std::cout << "encoder error " << error << ": "<< lodepng_error_text(error) << std::endl;
+}
+
+std::vector<unsigned char> Image::EncodePNG() const {
+  std::vector<unsigned char> rgba(static_cast<std::size_t>(width) * height * 4);
+  ToRGBA(rgba.data(), 0, height);
+
+  std::vector<unsigned char> png;
+  const unsigned error = lodepng::encode(png, rgba, width, height);
+  if (error) {
+    throw std::runtime_error(std::string("encoder error: ") + lodepng_error_text(error));
+  }
+  return png;
+}
+
+void Image::WriteFile(const char * filename) {
+  std::vector<unsigned char> image;
+  image.resize(width * height * 4);
+  ToRGBA(image.data(), 0, height);
+  WritePNG(filename, image, width, height);
 }
\ No newline at end of file
@@ -1,22 +1,60 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include "../raymath/Color.hpp"
 
 class Image
 {
+public:
+  // Initialise les pixels du rectangle [x0, x1) x [y0, y1).
+  using RegionInit = std::function<void(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1)>;
+  // Doit appeler RegionInit sur des zones couvrant toute l'image, depuis les threads de son choix.
+  using ParallelInit = std::function<void(const RegionInit& initRegion)>;
+
 private:
+  // Le tampon est alloué sans être touché : la première écriture (et donc le noeud NUMA
+  // de chaque page) revient au thread qui initialise la zone.
+  struct BufferDeleter {
+    BufferDeleter() noexcept : count(0) {}
+    explicit BufferDeleter(std::size_t n) noexcept : count(n) {}
+    void operator()(Color* pixels) const noexcept;
+    std::size_t count;
+  };
+
   unsigned int width = 0;
   unsigned int height = 0;
-  std::vector<Color> buffer;
+  std::unique_ptr<Color[], BufferDeleter> buffer;
+
+  void Allocate();
+  void FillRegion(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, Color c);
+
 public:
   Image(unsigned int w, unsigned int h);
   Image(unsigned int w, unsigned int h, Color c);
+  // Remplissage parallèle : chaque zone est écrite en premier par le thread qui la rendra.
+  Image(unsigned int w, unsigned int h, Color c, const ParallelInit& parallelInit);
   ~ Image();
 
+  Image(Image&& other) noexcept = default;
+  Image& operator=(Image&& other) noexcept = default;
+
+  unsigned int Width() const;
+  unsigned int Height() const;
+
   void SetPixel(unsigned int x, unsigned int y, Color color);
   Color GetPixel(unsigned int x, unsigned int y);
 
+  // Convertit les lignes [y0, y1) en RGBA 8 bits : rgba reçoit (y1 - y0) * width * 4 octets.
+  // Des plages de lignes disjointes peuvent être converties en parallèle.
+  void ToRGBA(unsigned char* rgba, unsigned int y0, unsigned int y1) const;
+  // Encode un tampon RGBA en PNG ; affiche l'erreur de l'encodeur le cas échéant.
+  static void WritePNG(const char* filename, const std::vector<unsigned char>& rgba, unsigned int w, unsigned int h);
+
   void WriteFile(const char* filename);
+  // PNG en mémoire (réponses du démon) ; lève std::runtime_error si l'encodeur échoue.
+  std::vector<unsigned char> EncodePNG() const;
 };
@@ -0,0 +1,244 @@
+#include "PngStream.hpp"
+#include "Image.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HETIC_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr std::size_t BytesPerPixel = 4;
+constexpr std::size_t IdatChunkSize = 1 << 16;
+
+void PutUint32(unsigned char* out, std::uint32_t value) {
+  out[0] = static_cast<unsigned char>(value >> 24);
+  out[1] = static_cast<unsigned char>(value >> 16);
+  out[2] = static_cast<unsigned char>(value >> 8);
+  out[3] = static_cast<unsigned char>(value);
+}
+
+unsigned char Paeth(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) return static_cast<unsigned char>(a);
+  if (pb <= pc) return static_cast<unsigned char>(b);
+  return static_cast<unsigned char>(c);
+}
+
+// Applique le filtre PNG `type` (0 à 4) ; out[0] reçoit le type.
+void FilterRow(int type, const unsigned char* row, const unsigned char* previous, std::size_t length, unsigned char* out) {
+  out[0] = static_cast<unsigned char>(type);
+  for (std::size_t i = 0; i < length; ++i) {
+    const int a = i >= BytesPerPixel ? row[i - BytesPerPixel] : 0;
+    const int b = previous[i];
+    const int c = i >= BytesPerPixel ? previous[i - BytesPerPixel] : 0;
+    int predictor = 0;
+    switch (type) {
+      case 1: predictor = a; break;
+      case 2: predictor = b; break;
+      case 3: predictor = (a + b) / 2; break;
+      case 4: predictor = Paeth(a, b, c); break;
+      default: break;
+    }
+    out[i + 1] = static_cast<unsigned char>(row[i] - predictor);
+  }
+}
+
+// Heuristique de libpng : le filtre dont la somme des octets (vus comme signés) est minimale.
+std::size_t FilterCost(const unsigned char* filtered, std::size_t length) {
+  std::size_t sum = 0;
+  for (std::size_t i = 1; i <= length; ++i) {
+    sum += static_cast<std::size_t>(std::abs(static_cast<int>(static_cast<signed char>(filtered[i]))));
+  }
+  return sum;
+}
+
+} // namespace
+
+#ifdef HETIC_HAVE_ZLIB
+struct PngStreamWriter::Deflater {
+  z_stream stream{};
+  std::vector<unsigned char> output = std::vector<unsigned char>(IdatChunkSize);
+};
+#else
+struct PngStreamWriter::Deflater {};
+#endif
+
+bool PngStreamWriter::Streaming() {
+#ifdef HETIC_HAVE_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+PngStreamWriter::PngStreamWriter() = default;
+
+PngStreamWriter::PngStreamWriter(const std::string& filename, unsigned int w, unsigned int h)
+{
+  Open(filename, w, h);
+}
+
+void PngStreamWriter::Open(const std::string& name, unsigned int w, unsigned int h)
+{
+  if (open) {
+    throw std::runtime_error("PngStreamWriter: " + filename + " is not finished");
+  }
+  filename = name;
+  width = w;
+  height = h;
+  rowsWritten = 0;
+
+#ifdef HETIC_HAVE_ZLIB
+  if (!deflater) {
+    auto created = std::make_unique<Deflater>();
+    if (deflateInit(&created->stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+      throw std::runtime_error("zlib: deflateInit failed");
+    }
+    deflater = std::move(created);
+  } else if (deflateReset(&deflater->stream) != Z_OK) {
+    throw std::runtime_error("zlib: deflateReset failed");
+  }
+
+  file = std::fopen(filename.c_str(), "wb");
+  if (!file) {
+    throw std::runtime_error("Unable to write image: " + filename);
+  }
+  open = true;
+
+  deflater->stream.next_out = deflater->output.data();
+  deflater->stream.avail_out = static_cast<uInt>(deflater->output.size());
+
+  static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+  if (std::fwrite(signature, 1, sizeof(signature), file) != sizeof(signature)) {
+    throw std::runtime_error("Unable to write image: " + filename);
+  }
+
+  unsigned char header[13];
+  PutUint32(header, width);
+  PutUint32(header + 4, height);
+  header[8] = 8;   // Bits par canal
+  header[9] = 6;   // RGBA
+  header[10] = 0;  // Compression deflate
+  header[11] = 0;  // Filtrage adaptatif par ligne
+  header[12] = 0;  // Pas d'entrelacement
+  WriteChunk("IHDR", header, sizeof(header));
+
+  const std::size_t rowBytes = static_cast<std::size_t>(width) * BytesPerPixel;
+  previousRow.assign(rowBytes, 0);
+  filteredRow.resize(rowBytes + 1);
+  candidateRow.resize(rowBytes + 1);
+#else
+  pending.clear();
+  pending.reserve(static_cast<std::size_t>(width) * height * BytesPerPixel);
+  open = true;
+#endif
+}
+
+PngStreamWriter::~PngStreamWriter()
+{
+#ifdef HETIC_HAVE_ZLIB
+  if (deflater) deflateEnd(&deflater->stream);
+#endif
+  if (file) std::fclose(file);
+}
+
+void PngStreamWriter::WriteChunk(const char type[4], const unsigned char* data, std::size_t size) {
+#ifdef HETIC_HAVE_ZLIB
+  unsigned char prefix[8];
+  PutUint32(prefix, static_cast<std::uint32_t>(size));
+  std::memcpy(prefix + 4, type, 4);
+
+  uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+  if (size > 0) crc = crc32(crc, data, static_cast<uInt>(size));
+  unsigned char suffix[4];
+  PutUint32(suffix, static_cast<std::uint32_t>(crc));
+
+  if (std::fwrite(prefix, 1, sizeof(prefix), file) != sizeof(prefix)
+      || (size > 0 && std::fwrite(data, 1, size, file) != size)
+      || std::fwrite(suffix, 1, sizeof(suffix), file) != sizeof(suffix)) {
+    throw std::runtime_error("Unable to write image: " + filename);
+  }
+#else
+  (void)type; (void)data; (void)size;
+#endif
+}
+
+// Écrit un chunk IDAT chaque fois que le tampon de sortie de zlib est plein.
+void PngStreamWriter::FlushDeflate(bool finish) {
+#ifdef HETIC_HAVE_ZLIB
+  z_stream& stream = deflater->stream;
+  for (;;) {
+    const int status = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+    if (status == Z_STREAM_ERROR) {
+      throw std::runtime_error("zlib: deflate failed");
+    }
+    const bool full = stream.avail_out == 0;
+    if (full || (finish && status == Z_STREAM_END)) {
+      WriteChunk("IDAT", deflater->output.data(), deflater->output.size() - stream.avail_out);
+      stream.next_out = deflater->output.data();
+      stream.avail_out = static_cast<uInt>(deflater->output.size());
+    }
+    if (finish ? status == Z_STREAM_END : (stream.avail_in == 0 && !full)) {
+      return;
+    }
+  }
+#else
+  (void)finish;
+#endif
+}
+
+void PngStreamWriter::WriteRow(const unsigned char* rgba) {
+  if (!open || rowsWritten >= height) {
+    throw std::runtime_error("PngStreamWriter: too many rows");
+  }
+  const std::size_t rowBytes = static_cast<std::size_t>(width) * BytesPerPixel;
+
+#ifdef HETIC_HAVE_ZLIB
+  std::size_t bestCost = static_cast<std::size_t>(-1);
+  for (int type = 0; type <= 4; ++type) {
+    FilterRow(type, rgba, previousRow.data(), rowBytes, candidateRow.data());
+    const std::size_t cost = FilterCost(candidateRow.data(), rowBytes);
+    if (cost < bestCost) {
+      bestCost = cost;
+      filteredRow.swap(candidateRow);
+    }
+  }
+  std::memcpy(previousRow.data(), rgba, rowBytes);
+
+  deflater->stream.next_in = filteredRow.data();
+  deflater->stream.avail_in = static_cast<uInt>(filteredRow.size());
+  FlushDeflate(false);
+#else
+  pending.insert(pending.end(), rgba, rgba + rowBytes);
+#endif
+  ++rowsWritten;
+}
+
+void PngStreamWriter::Finish() {
+  if (!open) {
+    return;
+  }
+  if (rowsWritten != height) {
+    throw std::runtime_error("PngStreamWriter: missing rows in " + filename);
+  }
+  open = false;
+
+#ifdef HETIC_HAVE_ZLIB
+  FlushDeflate(true);
+  WriteChunk("IEND", nullptr, 0);
+  const bool closed = std::fclose(file) == 0;
+  file = nullptr;
+  if (!closed) {
+    throw std::runtime_error("Unable to write image: " + filename);
+  }
+#else
+  Image::WritePNG(filename.c_str(), pending, width, height);
+#endif
+}
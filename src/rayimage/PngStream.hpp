@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Encodeur PNG incrémental (RGBA 8 bits) : chaque ligne est filtrée et compressée dès
+// qu'elle est reçue, sans copie RGBA de toute l'image.
+// Sans zlib à la compilation, les lignes sont gardées et encodées par lodepng à finish().
+// Un même objet peut encoder plusieurs fichiers à la suite (Open après Finish) : les tampons
+// de lignes et l'état de zlib sont réutilisés.
+class PngStreamWriter
+{
+public:
+  PngStreamWriter();
+  PngStreamWriter(const std::string& filename, unsigned int w, unsigned int h);
+  ~PngStreamWriter();
+
+  // Commence un nouveau fichier. Lève std::runtime_error si le précédent n'est pas terminé
+  // ou si le fichier ne peut pas être créé.
+  void Open(const std::string& filename, unsigned int w, unsigned int h);
+
+  PngStreamWriter(const PngStreamWriter&) = delete;
+  PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+
+  // Ligne suivante, de haut en bas : width * 4 octets RGBA.
+  // Lève std::runtime_error en cas d'erreur d'écriture ou de compression.
+  void WriteRow(const unsigned char* rgba);
+  // Termine le fichier une fois toutes les lignes écrites.
+  void Finish();
+
+  // true si l'encodage est réellement incrémental (zlib disponible).
+  static bool Streaming();
+
+private:
+  struct Deflater;
+
+  void WriteChunk(const char type[4], const unsigned char* data, std::size_t size);
+  void FlushDeflate(bool finish);
+
+  std::string filename;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int rowsWritten = 0;
+  bool open = false;
+  std::FILE* file = nullptr;
+  std::unique_ptr<Deflater> deflater;
+  std::vector<unsigned char> previousRow;   // Ligne précédente non filtrée (filtres Up, Average, Paeth)
+  std::vector<unsigned char> filteredRow;   // Octet de filtre + ligne filtrée
+  std::vector<unsigned char> candidateRow;
+  std::vector<unsigned char> pending;       // Sans zlib : image RGBA complète
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Constants.hpp"
+#include <cstdint>
+
+namespace math {
+
+// Mélangeur splitmix64 : transforme un compteur en 64 bits bien distribués.
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Générateur PCG32 (XSH-RR) dont l'état initial est dérivé de (seed, pixel, échantillon).
+// Chaque échantillon possède sa propre suite : le résultat ne dépend ni de l'ordre de rendu
+// ni du nombre de threads, contrairement à rand() qui partage un état global.
+class SampleRng {
+public:
+    constexpr SampleRng(std::uint64_t seed, std::uint64_t pixelIndex, std::uint64_t sampleIndex) noexcept
+        : m_state(0)
+        , m_increment((mix64(seed ^ 0xDA3E39CB94B95BDBull) << 1) | 1u) {
+        m_state = mix64(mix64(seed) ^ mix64(pixelIndex + 0x632BE59BD9B4E019ull) ^ sampleIndex) + m_increment;
+        nextUInt();
+    }
+
+    constexpr std::uint32_t nextUInt() noexcept {
+        const std::uint64_t old = m_state;
+        m_state = old * 6364136223846793005ull + m_increment;
+        const std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        const std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Réel uniforme dans [0, 1).
+    constexpr Real nextReal() noexcept {
+        return static_cast<Real>(nextUInt()) * Real(1.0 / 4294967296.0);
+    }
+
+    constexpr Real nextReal(Real min, Real max) noexcept {
+        return min + (max - min) * nextReal();
+    }
+
+private:
+    std::uint64_t m_state;
+    std::uint64_t m_increment;
+};
+
+} // namespace math
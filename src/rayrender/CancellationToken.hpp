@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace rayrender {
+
+// Jeton d'annulation coopérative : les workers le consultent entre deux tuiles
+// ou deux passes d'échantillons, jamais au milieu d'un pixel.
+// Il est annulé explicitement par cancel() ou implicitement une fois l'échéance passée.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void cancel() noexcept {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void setDeadline(Clock::time_point deadline) noexcept {
+        m_deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    // Repousse l'échéance (s'il y en a une), par exemple du temps passé suspendu par une préemption.
+    void extendDeadline(Clock::duration delay) noexcept {
+        Clock::rep deadline = m_deadline.load(std::memory_order_relaxed);
+        while (deadline != NoDeadline
+               && !m_deadline.compare_exchange_weak(deadline, deadline + delay.count(), std::memory_order_relaxed)) {
+        }
+    }
+
+    bool hasDeadline() const noexcept {
+        return m_deadline.load(std::memory_order_relaxed) != NoDeadline;
+    }
+
+    // Remet le jeton à zéro (ni annulé, ni échéance).
+    void reset() noexcept {
+        m_cancelled.store(false, std::memory_order_relaxed);
+        m_deadline.store(NoDeadline, std::memory_order_relaxed);
+    }
+
+    bool isCancelled() const noexcept {
+        if (m_cancelled.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        const Clock::rep deadline = m_deadline.load(std::memory_order_relaxed);
+        return deadline != NoDeadline && Clock::now().time_since_epoch().count() >= deadline;
+    }
+
+private:
+    static constexpr Clock::rep NoDeadline = std::numeric_limits<Clock::rep>::max();
+
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<Clock::rep> m_deadline{NoDeadline};
+};
+
+} // namespace rayrender
@@ -0,0 +1,142 @@
+#include "Executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <execution>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+namespace rayrender {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Défini par src/rayrender/CMakeLists.txt quand TBB manque : les algorithmes parallèles
+// de libstdc++ s'exécutent alors sur le thread appelant.
+#ifdef HETIC_SEQUENTIAL_PSTL
+constexpr bool ParallelStlAvailable = false;
+#else
+constexpr bool ParallelStlAvailable = true;
+#endif
+
+class SerialExecutor final : public Executor {
+public:
+    ExecutorKind kind() const noexcept override { return ExecutorKind::Serial; }
+    unsigned concurrency() const noexcept override { return 1; }
+
+    void run(std::size_t count, const Task& task, bool recordStats) override {
+        const Clock::time_point start = Clock::now();
+        for (std::size_t index = 0; index < count; ++index) {
+            task(index);
+        }
+        if (recordStats) {
+            m_stats.tasks += count;
+            m_stats.busySeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    }
+
+    std::vector<WorkerStats> stats() const override { return {m_stats}; }
+    void resetStats() override { m_stats = WorkerStats(); }
+
+private:
+    WorkerStats m_stats;
+};
+
+class ThreadPoolExecutor final : public Executor {
+public:
+    ThreadPoolExecutor(unsigned threads, const std::vector<int>& workerCpus, const std::vector<int>& workerNodes)
+        : m_pool(threads, workerCpus, workerNodes) {}
+
+    ExecutorKind kind() const noexcept override { return ExecutorKind::ThreadPool; }
+    unsigned concurrency() const noexcept override { return m_pool.size(); }
+
+    void run(std::size_t count, const Task& task, bool recordStats) override {
+        m_pool.run(count, [&](std::size_t index, unsigned) { task(index); }, recordStats);
+    }
+
+    std::vector<WorkerStats> stats() const override { return m_pool.stats(); }
+    void resetStats() override { m_pool.resetStats(); }
+
+private:
+    ThreadPool m_pool;
+};
+
+// Malgré son nom (celui de l'option), ce moteur lance les tuiles avec std::execution::par :
+// une tâche peut attendre sur la TileGate, prendre le verrou de l'encodeur au fil de l'eau ou
+// céder la main tant que sa file de lignes est pleine, ce que par_unseq interdit.
+class ParUnseqExecutor final : public Executor {
+public:
+    ParUnseqExecutor() {
+        if (!ParallelStlAvailable) {
+            static std::once_flag warned;
+            std::call_once(warned, [] {
+                std::cerr << "Warning: built without TBB, the par_unseq executor runs on a single thread" << std::endl;
+            });
+        }
+    }
+
+    ExecutorKind kind() const noexcept override { return ExecutorKind::ParUnseq; }
+    unsigned concurrency() const noexcept override {
+        return ParallelStlAvailable ? ThreadPool::defaultThreadCount() : 1;
+    }
+
+    void run(std::size_t count, const Task& task, bool) override {
+        std::vector<std::size_t> indices(count);
+        std::iota(indices.begin(), indices.end(), std::size_t(0));
+
+        // Une exception qui sort d'un algorithme parallèle appelle std::terminate :
+        // on garde la première, sans verrou, et on la relance après la boucle.
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t index) {
+            try {
+                task(index);
+            } catch (...) {
+                if (!failed.exchange(true)) error = std::current_exception();
+            }
+        });
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<WorkerStats> stats() const override { return {}; }
+    void resetStats() override {}
+};
+
+} // namespace
+
+ExecutorKind ParseExecutorKind(const std::string& name) {
+    if (name == "serial") return ExecutorKind::Serial;
+    if (name == "pool") return ExecutorKind::ThreadPool;
+    if (name == "par_unseq") return ExecutorKind::ParUnseq;
+    throw std::invalid_argument("Unknown executor: " + name + " (expected serial, pool or par_unseq)");
+}
+
+const char* ExecutorKindName(ExecutorKind kind) noexcept {
+    switch (kind) {
+        case ExecutorKind::Serial: return "serial";
+        case ExecutorKind::ParUnseq: return "par_unseq";
+        case ExecutorKind::ThreadPool: break;
+    }
+    return "pool";
+}
+
+std::unique_ptr<Executor> MakeExecutor(ExecutorKind kind, unsigned threads,
+                                       const std::vector<int>& workerCpus,
+                                       const std::vector<int>& workerNodes) {
+    switch (kind) {
+        case ExecutorKind::Serial: return std::make_unique<SerialExecutor>();
+        case ExecutorKind::ParUnseq: return std::make_unique<ParUnseqExecutor>();
+        case ExecutorKind::ThreadPool: break;
+    }
+    return std::make_unique<ThreadPoolExecutor>(threads, workerCpus, workerNodes);
+}
+
+} // namespace rayrender
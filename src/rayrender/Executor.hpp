@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace rayrender {
+
+// Moteur d'exécution des boucles de rendu, choisi à l'exécution.
+enum class ExecutorKind {
+    Serial,      // Tout sur le thread appelant, dans l'ordre : débogage déterministe
+    ThreadPool,  // Pool persistant à vol de travail (épinglage et NUMA)
+    ParUnseq     // Algorithmes parallèles de la bibliothèque standard (std::execution::par, voir Executor.cpp)
+};
+
+// Lit "serial", "pool" ou "par_unseq" ; lève std::invalid_argument sinon.
+ExecutorKind ParseExecutorKind(const std::string& name);
+const char* ExecutorKindName(ExecutorKind kind) noexcept;
+
+// Exécute task(0..count-1) et bloque jusqu'à la fin. Les tâches d'un même run() peuvent
+// s'exécuter en parallèle et dans n'importe quel ordre. Chaque moteur garantit la progression
+// d'une tâche qui attend (std::execution::par, pas par_unseq) : une tâche peut donc bloquer sur
+// la TileGate (préemption), attendre une place dans la file de lignes du StreamingEncoder ou
+// prendre un verrou dans l'écouteur de tuiles. Elle ne doit pas attendre une autre tâche du
+// même run(). La première exception levée est relancée par run().
+class Executor {
+public:
+    using Task = std::function<void(std::size_t index)>;
+
+    virtual ~Executor() = default;
+
+    virtual ExecutorKind kind() const noexcept = 0;
+    // Nombre de tâches exécutées en même temps au plus.
+    virtual unsigned concurrency() const noexcept = 0;
+
+    // recordStats == false : le run n'est pas compté dans stats() (travail annexe).
+    virtual void run(std::size_t count, const Task& task, bool recordStats = true) = 0;
+
+    // Statistiques par worker ; vide si le moteur ne les connaît pas (par_unseq).
+    virtual std::vector<WorkerStats> stats() const = 0;
+    virtual void resetStats() = 0;
+};
+
+// threads == 0 : tous les threads matériels. workerCpus et workerNodes ne servent qu'au pool.
+// par_unseq ignore threads : std::execution::par répartit lui-même les tâches (sur TBB avec
+// GCC ; sans TBB à la compilation, sur le seul thread appelant).
+std::unique_ptr<Executor> MakeExecutor(ExecutorKind kind, unsigned threads,
+                                       const std::vector<int>& workerCpus = {},
+                                       const std::vector<int>& workerNodes = {});
+
+} // namespace rayrender
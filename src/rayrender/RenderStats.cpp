@@ -0,0 +1,111 @@
+#include "RenderStats.hpp"
+
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace rayrender {
+
+namespace {
+
+// Les blocs ne sont jamais libérés : un thread terminé garde ses compteurs dans les totaux.
+constexpr std::size_t MaxThreadSlots = 1024;
+
+struct Registry {
+    std::mutex mutex;
+    std::atomic<ThreadStats*> slots[MaxThreadSlots] = {};
+    std::atomic<std::size_t> count{0};
+    ThreadStats overflow;  // Au-delà de MaxThreadSlots threads : bloc partagé, comptes approximatifs
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+} // namespace
+
+namespace stats {
+
+ThreadStats& RegisterThread() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const std::size_t index = reg.count.load(std::memory_order_relaxed);
+    if (index >= MaxThreadSlots) {
+        return reg.overflow;
+    }
+    ThreadStats* block = new ThreadStats();
+    reg.slots[index].store(block, std::memory_order_release);
+    reg.count.store(index + 1, std::memory_order_release);
+    return *block;
+}
+
+} // namespace stats
+
+namespace {
+
+void accumulate(StatsSnapshot& total, const ThreadStats& block) {
+    total.pixels += block.pixels.load(std::memory_order_relaxed);
+    for (std::size_t kind = 0; kind < RayKindCount; ++kind) {
+        total.rays[kind] += block.rays[kind].load(std::memory_order_relaxed);
+    }
+    total.sphereTests += block.sphereTests.load(std::memory_order_relaxed);
+    total.planeTests += block.planeTests.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::uint64_t StatsSnapshot::totalRays() const noexcept {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : rays) total += count;
+    return total;
+}
+
+StatsSnapshot StatsSnapshot::operator-(const StatsSnapshot& before) const noexcept {
+    StatsSnapshot delta;
+    delta.pixels = pixels - before.pixels;
+    for (std::size_t kind = 0; kind < RayKindCount; ++kind) {
+        delta.rays[kind] = rays[kind] - before.rays[kind];
+    }
+    delta.sphereTests = sphereTests - before.sphereTests;
+    delta.planeTests = planeTests - before.planeTests;
+    return delta;
+}
+
+void PrintRenderStats(std::ostream& out, const StatsSnapshot& stats, double seconds) {
+    const auto line = [&](const char* name, std::uint64_t count) {
+        out << std::left << std::setw(20) << name << std::right << std::setw(14) << count;
+        if (seconds > 0) {
+            out << std::fixed << std::setprecision(2) << std::setw(12) << count / seconds / 1e6 << " M/s";
+        }
+        out << "\n";
+    };
+
+    line("pixels", stats.pixels);
+    line("primary rays", stats.rays[static_cast<unsigned>(RayKind::Primary)]);
+    line("shadow rays", stats.rays[static_cast<unsigned>(RayKind::Shadow)]);
+    line("reflection rays", stats.rays[static_cast<unsigned>(RayKind::Reflection)]);
+    line("total rays", stats.totalRays());
+    line("sphere tests", stats.sphereTests);
+    line("plane tests", stats.planeTests);
+}
+
+namespace stats {
+
+StatsSnapshot Snapshot() noexcept {
+    Registry& reg = registry();
+    StatsSnapshot total;
+    const std::size_t count = reg.count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (const ThreadStats* block = reg.slots[i].load(std::memory_order_acquire)) {
+            accumulate(total, *block);
+        }
+    }
+    accumulate(total, reg.overflow);
+    return total;
+}
+
+} // namespace stats
+
+} // namespace rayrender
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace rayrender {
+
+enum class RayKind : unsigned {
+    Primary,     // Rayons caméra
+    Shadow,      // Rayons vers la lumière
+    Reflection   // Rayons réfléchis
+};
+constexpr std::size_t RayKindCount = 3;
+
+// Compteurs d'un thread, seul sur sa ligne de cache : un seul écrivain (le thread),
+// lus sans verrou par les autres. Pas de read-modify-write : un load et un store relaxed.
+struct alignas(64) ThreadStats {
+    std::atomic<std::uint64_t> pixels{0};       // Pixels dont la valeur finale est écrite
+    std::atomic<std::uint64_t> rays[RayKindCount] = {};
+    std::atomic<std::uint64_t> sphereTests{0};  // Appels à Sphere::intersect
+    std::atomic<std::uint64_t> planeTests{0};   // Appels à Plane::intersect
+};
+
+// Somme des compteurs de tous les threads à un instant donné.
+struct StatsSnapshot {
+    std::uint64_t pixels = 0;
+    std::uint64_t rays[RayKindCount] = {};
+    std::uint64_t sphereTests = 0;
+    std::uint64_t planeTests = 0;
+
+    std::uint64_t totalRays() const noexcept;
+    // Différence entre deux instantanés (compteurs pendant un rendu).
+    StatsSnapshot operator-(const StatsSnapshot& before) const noexcept;
+};
+
+// Affiche pixels, rayons par type et tests d'intersection, avec leur débit sur `seconds`.
+void PrintRenderStats(std::ostream& out, const StatsSnapshot& stats, double seconds);
+
+namespace stats {
+
+// Enregistre un nouveau bloc (seul moment où un verrou est pris).
+ThreadStats& RegisterThread();
+
+// Initialisation constante : accès TLS direct, sans fonction d'enrobage à chaque appel.
+inline thread_local ThreadStats* t_localStats = nullptr;
+
+// Bloc du thread appelant, enregistré au premier appel.
+inline ThreadStats& Local() noexcept {
+    ThreadStats* block = t_localStats;
+    if (!block) {
+        block = &RegisterThread();
+        t_localStats = block;
+    }
+    return *block;
+}
+
+// Somme de tous les blocs enregistrés ; aucun verrou, appelable à tout moment.
+StatsSnapshot Snapshot() noexcept;
+
+inline void Add(std::atomic<std::uint64_t>& counter, std::uint64_t count) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+inline void CountRay(RayKind kind) noexcept {
+    Add(Local().rays[static_cast<unsigned>(kind)], 1);
+}
+
+inline void CountSphereTest() noexcept {
+    Add(Local().sphereTests, 1);
+}
+
+inline void CountPlaneTest() noexcept {
+    Add(Local().planeTests, 1);
+}
+
+inline void CountPixels(std::uint64_t count) noexcept {
+    Add(Local().pixels, count);
+}
+
+} // namespace stats
+
+} // namespace rayrender
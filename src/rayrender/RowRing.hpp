@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace rayrender {
+
+// File circulaire bornée, sans verrou, à plusieurs producteurs et un seul consommateur
+// (schéma de D. Vyukov : un numéro de séquence par case). Les workers y poussent les
+// index de lignes terminées, le thread d'encodage les retire.
+class RowRing {
+public:
+    using Value = std::size_t;
+
+    // capacity est arrondie à la puissance de deux supérieure.
+    explicit RowRing(std::size_t capacity) {
+        std::size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        m_cells = std::make_unique<Cell[]>(rounded);
+        m_mask = rounded - 1;
+        for (std::size_t i = 0; i < rounded; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    RowRing(const RowRing&) = delete;
+    RowRing& operator=(const RowRing&) = delete;
+
+    // Producteurs. Retourne false si la file est pleine.
+    bool tryPush(Value value) noexcept {
+        std::size_t position = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[position & m_mask];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consommateur unique.
+    std::optional<Value> tryPop() noexcept {
+        Cell& cell = m_cells[m_head & m_mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != m_head + 1) {
+            return std::nullopt;
+        }
+        const Value value = cell.value;
+        cell.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+        ++m_head;
+        return value;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        Value value = 0;
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t m_mask = 0;
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::size_t m_head = 0;
+};
+
+} // namespace rayrender
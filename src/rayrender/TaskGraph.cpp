@@ -0,0 +1,146 @@
+#include "TaskGraph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+
+namespace rayrender {
+
+void PrintStageTimings(std::ostream& out, const std::vector<StageTiming>& timings) {
+    double wall = 0.0;
+    double criticalBusy = 0.0;
+
+    out << "stage                start (ms)    end (ms)   duration (ms)\n";
+    for (const StageTiming& timing : timings) {
+        out << (timing.critical ? "* " : "  ") << std::left << std::setw(18) << timing.name << std::right;
+        if (!timing.ran) {
+            out << "   (not run)\n";
+            continue;
+        }
+        const double duration = timing.end - timing.start;
+        out << std::fixed << std::setprecision(1)
+            << std::setw(12) << timing.start * 1000.0
+            << std::setw(12) << timing.end * 1000.0
+            << std::setw(16) << duration * 1000.0 << "\n";
+        wall = std::max(wall, timing.end);
+        if (timing.critical) criticalBusy += duration;
+    }
+    out << "critical path (*) : " << std::fixed << std::setprecision(1) << criticalBusy * 1000.0
+        << " ms of work, total " << wall * 1000.0 << " ms\n";
+}
+
+TaskGraph::StageId TaskGraph::add(std::string name, Stage stage, std::vector<StageId> dependencies) {
+    for (StageId dependency : dependencies) {
+        if (dependency >= m_nodes.size()) {
+            throw std::invalid_argument("TaskGraph: unknown dependency for stage " + name);
+        }
+    }
+    m_nodes.push_back(Node{std::move(name), std::move(stage), std::move(dependencies)});
+    return m_nodes.size() - 1;
+}
+
+const std::vector<StageTiming>& TaskGraph::timings() const noexcept {
+    return m_timings;
+}
+
+void TaskGraph::run() {
+    using Clock = std::chrono::steady_clock;
+    enum class State { Waiting, Running, Done, Failed, Skipped };
+
+    const std::size_t count = m_nodes.size();
+    m_timings.assign(count, StageTiming());
+    for (std::size_t i = 0; i < count; ++i) m_timings[i].name = m_nodes[i].name;
+
+    std::vector<State> states(count, State::Waiting);
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::exception_ptr error;
+    std::size_t running = 0;
+    const Clock::time_point origin = Clock::now();
+
+    auto seconds = [&] { return std::chrono::duration<double>(Clock::now() - origin).count(); };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        // Lance toutes les étapes prêtes ; saute celles dont une dépendance a échoué.
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (states[i] != State::Waiting) continue;
+
+                bool ready = true;
+                bool blocked = false;
+                for (StageId dependency : m_nodes[i].dependencies) {
+                    if (states[dependency] == State::Failed || states[dependency] == State::Skipped) blocked = true;
+                    if (states[dependency] != State::Done) ready = false;
+                }
+                if (blocked) {
+                    states[i] = State::Skipped;
+                    progress = true;
+                } else if (ready) {
+                    states[i] = State::Running;
+                    ++running;
+                    m_timings[i].ran = true;
+                    m_timings[i].start = seconds();
+                    threads.emplace_back([&, i] {
+                        std::exception_ptr stageError;
+                        try {
+                            m_nodes[i].stage();
+                        } catch (...) {
+                            stageError = std::current_exception();
+                        }
+                        std::lock_guard<std::mutex> guard(mutex);
+                        m_timings[i].end = seconds();
+                        states[i] = stageError ? State::Failed : State::Done;
+                        if (stageError && !error) error = stageError;
+                        --running;
+                        changed.notify_one();
+                    });
+                }
+            }
+        }
+
+        if (running == 0) break;
+        changed.wait(lock);
+    }
+    lock.unlock();
+
+    for (std::thread& thread : threads) thread.join();
+    markCriticalPath();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// En remontant depuis l'étape qui finit en dernier, on suit à chaque fois la dépendance
+// terminée le plus tard : c'est elle qui a retardé le démarrage.
+void TaskGraph::markCriticalPath() {
+    std::size_t current = m_timings.size();
+    for (std::size_t i = 0; i < m_timings.size(); ++i) {
+        if (m_timings[i].ran && (current == m_timings.size() || m_timings[i].end > m_timings[current].end)) {
+            current = i;
+        }
+    }
+
+    while (current < m_timings.size()) {
+        m_timings[current].critical = true;
+        std::size_t next = m_timings.size();
+        for (StageId dependency : m_nodes[current].dependencies) {
+            if (next == m_timings.size() || m_timings[dependency].end > m_timings[next].end) {
+                next = dependency;
+            }
+        }
+        current = next;
+    }
+}
+
+} // namespace rayrender
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rayrender {
+
+// Mesure d'une étape après TaskGraph::run(), en secondes depuis le début du run.
+struct StageTiming {
+    std::string name;
+    double start = 0.0;
+    double end = 0.0;
+    bool ran = false;       // false : une dépendance a échoué, l'étape n'a pas été lancée
+    bool critical = false;  // Sur le chemin critique (chaîne de dépendances qui a fixé la fin du run)
+};
+
+// Affiche chaque étape (début, fin, durée), marque le chemin critique et compare sa durée au temps total.
+void PrintStageTimings(std::ostream& out, const std::vector<StageTiming>& timings);
+
+// Graphe de tâches à gros grain (chargement, rendu, encodage...) : chaque étape démarre sur
+// son propre thread dès que ses dépendances sont terminées, les étapes indépendantes se
+// chevauchent. Le parallélisme fin reste celui du TileRenderer appelé par les étapes.
+class TaskGraph {
+public:
+    using StageId = std::size_t;
+    using Stage = std::function<void()>;
+
+    // Les dépendances doivent avoir été ajoutées avant : le graphe est acyclique par construction.
+    StageId add(std::string name, Stage stage, std::vector<StageId> dependencies = {});
+
+    // Exécute toutes les étapes et bloque jusqu'à la fin. Si une étape lève une exception,
+    // les étapes qui en dépendent ne sont pas lancées et la première exception est relancée
+    // une fois les étapes en cours terminées.
+    void run();
+
+    // Mesures du dernier run(), dans l'ordre d'ajout.
+    const std::vector<StageTiming>& timings() const noexcept;
+
+private:
+    struct Node {
+        std::string name;
+        Stage stage;
+        std::vector<StageId> dependencies;
+    };
+
+    void markCriticalPath();
+
+    std::vector<Node> m_nodes;
+    std::vector<StageTiming> m_timings;
+};
+
+} // namespace rayrender
@@ -0,0 +1,266 @@
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+
+namespace rayrender {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// xorshift64 : tirage des victimes, propre à chaque worker.
+std::uint64_t nextRandom(std::uint64_t& state) noexcept {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
+void PrintWorkerStats(std::ostream& out, const std::vector<WorkerStats>& stats) {
+    if (stats.empty()) {
+        out << "no scheduler statistics for this executor\n";
+        return;
+    }
+
+    std::size_t totalTasks = 0;
+    std::size_t totalSteals = 0;
+    double totalBusy = 0.0;
+    double totalIdle = 0.0;
+
+    out << "worker    tasks   steals   failed    busy (s)    idle (s)\n";
+    for (std::size_t i = 0; i < stats.size(); ++i) {
+        const WorkerStats& s = stats[i];
+        out << std::setw(6) << i
+            << std::setw(9) << s.tasks
+            << std::setw(9) << s.steals
+            << std::setw(9) << s.failedSteals
+            << std::fixed << std::setprecision(3)
+            << std::setw(12) << s.busySeconds
+            << std::setw(12) << s.idleSeconds << "\n";
+        totalTasks += s.tasks;
+        totalSteals += s.steals;
+        totalBusy += s.busySeconds;
+        totalIdle += s.idleSeconds;
+    }
+
+    const double total = totalBusy + totalIdle;
+    out << " total" << std::setw(9) << totalTasks << std::setw(9) << totalSteals
+        << "          " << std::fixed << std::setprecision(3)
+        << std::setw(12) << totalBusy << std::setw(12) << totalIdle << "\n";
+    if (total > 0.0) {
+        out << "utilisation : " << std::setprecision(1) << (100.0 * totalBusy / total) << " %\n";
+    }
+}
+
+ThreadPool::ThreadPool(unsigned threadCount, const std::vector<int>& workerCpus, const std::vector<int>& workerNodes) {
+    if (threadCount == 0) {
+        threadCount = defaultThreadCount();
+    }
+
+    m_workerStates.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        auto state = std::make_unique<Worker>();
+        state->rngState = 0x9E3779B97F4A7C15ull * (i + 1);
+        state->cpu = i < workerCpus.size() ? workerCpus[i] : -1;
+        if (i < workerNodes.size()) {
+            for (unsigned peer = 0; peer < threadCount && peer < workerNodes.size(); ++peer) {
+                if (peer != i && workerNodes[peer] == workerNodes[i]) state->sameNodePeers.push_back(peer);
+            }
+        }
+        m_workerStates.push_back(std::move(state));
+    }
+
+    m_workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+unsigned ThreadPool::size() const noexcept {
+    return static_cast<unsigned>(m_workers.size());
+}
+
+unsigned ThreadPool::defaultThreadCount() noexcept {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+std::vector<WorkerStats> ThreadPool::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<WorkerStats> result;
+    result.reserve(m_workerStates.size());
+    for (const auto& state : m_workerStates) {
+        result.push_back(state->stats);
+    }
+    return result;
+}
+
+void ThreadPool::resetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& state : m_workerStates) {
+        state->stats = WorkerStats();
+    }
+}
+
+void ThreadPool::run(std::size_t taskCount, const Task& task, bool recordStats) {
+    if (taskCount == 0) {
+        return;
+    }
+
+    // m_done.wait() relâche m_mutex : sans ce verrou, un second run() réinitialiserait les deques en cours.
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::vector<WorkerStats> savedStats;
+    if (!recordStats) {
+        for (const auto& state : m_workerStates) savedStats.push_back(state->stats);
+    }
+
+    // Chaque worker reçoit un bloc contigu de tâches, empilé à l'envers pour
+    // qu'il les dépile dans l'ordre croissant.
+    const std::size_t workerCount = m_workerStates.size();
+    for (std::size_t w = 0; w < workerCount; ++w) {
+        const std::size_t begin = taskCount * w / workerCount;
+        const std::size_t end = taskCount * (w + 1) / workerCount;
+        Worker& state = *m_workerStates[w];
+        state.deque.reset(end - begin);
+        state.runBusySeconds = 0.0;
+        for (std::size_t i = end; i > begin; --i) {
+            state.deque.push(i - 1);
+        }
+    }
+
+    m_task = &task;
+    m_remaining.store(taskCount, std::memory_order_relaxed);
+    m_error = nullptr;
+    m_activeWorkers = size();
+    ++m_generation;
+
+    const Clock::time_point start = Clock::now();
+    m_wake.notify_all();
+    m_done.wait(lock, [this] { return m_activeWorkers == 0; });
+    const double wall = secondsSince(start);
+    m_task = nullptr;
+
+    for (std::size_t w = 0; w < workerCount; ++w) {
+        Worker& state = *m_workerStates[w];
+        if (!recordStats) {
+            state.stats = savedStats[w];
+            continue;
+        }
+        state.stats.busySeconds += state.runBusySeconds;
+        state.stats.idleSeconds += wall > state.runBusySeconds ? wall - state.runBusySeconds : 0.0;
+    }
+
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+std::optional<std::size_t> ThreadPool::steal(unsigned thiefIndex) {
+    const std::size_t workerCount = m_workerStates.size();
+    if (workerCount < 2) {
+        return std::nullopt;
+    }
+
+    Worker& thief = *m_workerStates[thiefIndex];
+
+    // D'abord les workers du même noeud NUMA : leurs tuiles sont en mémoire locale.
+    const std::vector<unsigned>& peers = thief.sameNodePeers;
+    for (std::size_t attempt = 0; attempt < peers.size(); ++attempt) {
+        if (auto value = stealFrom(thief, peers[nextRandom(thief.rngState) % peers.size()])) {
+            return value;
+        }
+    }
+
+    for (std::size_t attempt = 0; attempt < workerCount; ++attempt) {
+        std::size_t victim = nextRandom(thief.rngState) % (workerCount - 1);
+        if (victim >= thiefIndex) ++victim;
+
+        if (auto value = stealFrom(thief, static_cast<unsigned>(victim))) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::size_t> ThreadPool::stealFrom(Worker& thief, unsigned victim) {
+    if (auto value = m_workerStates[victim]->deque.steal()) {
+        ++thief.stats.steals;
+        return value;
+    }
+    ++thief.stats.failedSteals;
+    return std::nullopt;
+}
+
+// Chaque worker attend une nouvelle génération, vide sa deque puis vole
+// jusqu'à ce que toutes les tâches du run() soient terminées.
+void ThreadPool::workerLoop(unsigned workerIndex) {
+    unsigned long seenGeneration = 0;
+    Worker& self = *m_workerStates[workerIndex];
+
+    if (self.cpu >= 0) {
+        PinCurrentThread(self.cpu);
+    }
+
+    for (;;) {
+        const Task* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) return;
+            seenGeneration = m_generation;
+            task = m_task;
+        }
+
+        for (;;) {
+            std::optional<std::size_t> index = self.deque.pop();
+            if (!index) {
+                index = steal(workerIndex);
+            }
+            if (!index) {
+                if (m_remaining.load(std::memory_order_acquire) == 0) break;
+                std::this_thread::yield();
+                continue;
+            }
+
+            const Clock::time_point taskStart = Clock::now();
+            try {
+                (*task)(*index, workerIndex);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+            }
+            self.runBusySeconds += secondsSince(taskStart);
+            ++self.stats.tasks;
+            m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_activeWorkers == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+} // namespace rayrender
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace rayrender {
+
+// Statistiques d'ordonnancement d'un worker, cumulées depuis le dernier reset.
+struct WorkerStats {
+    std::size_t tasks = 0;          // Tâches exécutées (locales + volées)
+    std::size_t steals = 0;         // Tâches volées à un autre worker
+    std::size_t failedSteals = 0;   // Tentatives de vol sur une deque vide ou perdues
+    double busySeconds = 0.0;       // Temps passé à exécuter des tâches
+    double idleSeconds = 0.0;       // Temps de run() passé sans tâche à exécuter
+};
+
+// Affiche un tableau par worker (tâches, vols, temps actif/inactif).
+void PrintWorkerStats(std::ostream& out, const std::vector<WorkerStats>& stats);
+
+// Pool de threads persistant à vol de travail : les workers sont créés une seule fois
+// et réutilisés pour chaque appel à run().
+// Chaque worker possède une deque sans verrou pré-remplie avec un bloc contigu de tâches ;
+// lorsqu'elle est vide, il vole par le haut de la deque d'une victime tirée au hasard.
+class ThreadPool {
+public:
+    // Signature d'une tâche : index de la tâche et index du worker qui l'exécute.
+    using Task = std::function<void(std::size_t taskIndex, unsigned workerIndex)>;
+
+    // threadCount == 0 : autant de workers que de threads matériels.
+    // workerCpus (optionnel) : CPU sur lequel épingler chaque worker.
+    // workerNodes (optionnel) : noeud NUMA de chaque worker ; les vols se font d'abord dans le même noeud.
+    explicit ThreadPool(unsigned threadCount = 0,
+                        const std::vector<int>& workerCpus = {},
+                        const std::vector<int>& workerNodes = {});
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const noexcept;
+
+    // Exécute task(0..taskCount-1) sur les workers et bloque jusqu'à la fin.
+    // La première exception levée par une tâche est relancée ici.
+    // Des appels depuis plusieurs threads (étapes d'un TaskGraph) s'exécutent l'un après l'autre.
+    // recordStats == false : le run n'est pas compté dans stats() (travail annexe).
+    void run(std::size_t taskCount, const Task& task, bool recordStats = true);
+
+    // Statistiques cumulées de tous les run() depuis le dernier resetStats().
+    std::vector<WorkerStats> stats() const;
+    void resetStats();
+
+    static unsigned defaultThreadCount() noexcept;
+
+private:
+    struct alignas(64) Worker {
+        WorkStealingDeque deque;
+        WorkerStats stats;
+        double runBusySeconds = 0.0;
+        std::uint64_t rngState = 0;
+        int cpu = -1;
+        std::vector<unsigned> sameNodePeers;
+    };
+
+    void workerLoop(unsigned workerIndex);
+    std::optional<std::size_t> steal(unsigned thiefIndex);
+    std::optional<std::size_t> stealFrom(Worker& thief, unsigned victim);
+
+    std::vector<std::unique_ptr<Worker>> m_workerStates;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_runMutex;  // Un seul run() à la fois
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stopping = false;
+    unsigned long m_generation = 0;
+    unsigned m_activeWorkers = 0;
+
+    const Task* m_task = nullptr;
+    std::atomic<std::size_t> m_remaining{0};
+    std::exception_ptr m_error;
+};
+
+} // namespace rayrender
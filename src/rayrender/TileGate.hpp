@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace rayrender {
+
+// Barrière que les workers franchissent entre deux tuiles. Fermée, elle les retient :
+// un rendu plus prioritaire peut occuper les CPU, puis le rendu retenu reprend à la tuile suivante.
+// Ouverte (cas courant), pass() ne coûte qu'une lecture atomique.
+class TileGate {
+public:
+    void close() noexcept {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed.store(true, std::memory_order_relaxed);
+    }
+
+    void open() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed.store(false, std::memory_order_relaxed);
+        }
+        m_opened.notify_all();
+    }
+
+    bool isClosed() const noexcept {
+        return m_closed.load(std::memory_order_relaxed);
+    }
+
+    // Bloque tant que la barrière est fermée.
+    void pass() const {
+        if (!m_closed.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_opened.wait(lock, [this] { return !m_closed.load(std::memory_order_relaxed); });
+    }
+
+private:
+    std::atomic<bool> m_closed{false};
+    mutable std::mutex m_mutex;
+    mutable std::condition_variable m_opened;
+};
+
+} // namespace rayrender
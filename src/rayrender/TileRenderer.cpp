@@ -0,0 +1,285 @@
+#include "TileRenderer.hpp"
+#include "RenderStats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+namespace rayrender {
+
+std::vector<Tile> MakeTiles(int width, int height, int tileSize, TraversalOrder order) {
+    if (tileSize <= 0) {
+        throw std::invalid_argument("TileRenderer: tile size must be positive");
+    }
+
+    std::vector<Tile> tiles;
+    if (width <= 0 || height <= 0) {
+        return tiles;
+    }
+
+    if (order == TraversalOrder::Scanline) {
+        tiles.reserve(static_cast<std::size_t>(height));
+        for (int y = 0; y < height; ++y) {
+            tiles.push_back(Tile{y, 0, y, width, y + 1});
+        }
+        return tiles;
+    }
+
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+    tiles.reserve(static_cast<std::size_t>(tilesX) * tilesY);
+
+    for (const PixelOffset& cell : CurveOrder(order, tilesX, tilesY)) {
+        Tile tile;
+        tile.index = static_cast<int>(tiles.size());
+        tile.x0 = cell.x * tileSize;
+        tile.y0 = cell.y * tileSize;
+        tile.x1 = std::min(tile.x0 + tileSize, width);
+        tile.y1 = std::min(tile.y0 + tileSize, height);
+        tiles.push_back(tile);
+    }
+
+    return tiles;
+}
+
+namespace {
+
+unsigned resolveThreadCount(unsigned threads) {
+    return threads > 0 ? threads : ThreadPool::defaultThreadCount();
+}
+
+// Seul le pool épingle ses workers.
+std::vector<int> assignWorkerCpus(const CpuTopology& topology, const RenderSettings& settings) {
+    if (settings.executor != ExecutorKind::ThreadPool) {
+        return {};
+    }
+    return AssignCpus(topology, resolveThreadCount(settings.threads), settings.affinity);
+}
+
+std::vector<int> nodesOf(const CpuTopology& topology, const std::vector<int>& cpus) {
+    std::vector<int> nodes;
+    nodes.reserve(cpus.size());
+    for (int cpu : cpus) nodes.push_back(topology.nodeOfCpu(cpu));
+    return nodes;
+}
+
+} // namespace
+
+TileRenderer::TileRenderer(const RenderSettings& settings)
+    : m_settings(settings)
+    , m_topology(CpuTopology::Detect())
+    , m_workerCpus(assignWorkerCpus(m_topology, settings))
+    , m_executor(MakeExecutor(settings.executor, resolveThreadCount(settings.threads), m_workerCpus, nodesOf(m_topology, m_workerCpus))) {
+    m_settings.threads = m_executor->concurrency();
+    setTraversalOrder(settings.order);
+}
+
+void TileRenderer::setTraversalOrder(TraversalOrder order) {
+    m_settings.order = order;
+    m_pixelOrder.clear();
+    if (order == TraversalOrder::Morton || order == TraversalOrder::Hilbert) {
+        m_pixelOrder = CurveOrder(order, m_settings.tileSize, m_settings.tileSize);
+    }
+}
+
+const RenderSettings& TileRenderer::settings() const noexcept {
+    return m_settings;
+}
+
+unsigned TileRenderer::threadCount() const noexcept {
+    return m_executor->concurrency();
+}
+
+ExecutorKind TileRenderer::executorKind() const noexcept {
+    return m_executor->kind();
+}
+
+const CpuTopology& TileRenderer::topology() const noexcept {
+    return m_topology;
+}
+
+const std::vector<int>& TileRenderer::workerCpus() const noexcept {
+    return m_workerCpus;
+}
+
+void TileRenderer::firstTouch(int width, int height, const TileFunction& touchTile) {
+    // Même découpage et même répartition initiale des blocs de tuiles que render(),
+    // mais sans annulation (toute l'image doit être initialisée) ni statistiques.
+    runTiles(width, height, touchTile, false, false);
+}
+
+void TileRenderer::setCancellationToken(const CancellationToken* token) noexcept {
+    m_cancellation = token;
+}
+
+const CancellationToken* TileRenderer::cancellationToken() const noexcept {
+    return m_cancellation;
+}
+
+bool TileRenderer::isCancelled() const noexcept {
+    return m_cancellation && m_cancellation->isCancelled();
+}
+
+void TileRenderer::setTileGate(const TileGate* gate) noexcept {
+    m_gate = gate;
+}
+
+bool TileRenderer::render(int width, int height, const TileFunction& renderTile) {
+    return runTiles(width, height, renderTile, true, true);
+}
+
+void TileRenderer::renderAll(int width, int height, const TileFunction& renderTile) {
+    runTiles(width, height, renderTile, false, true);
+}
+
+void TileRenderer::parallelFor(std::size_t count, const std::function<void(std::size_t index)>& fn) {
+    if (!m_gate) {
+        m_executor->run(count, fn);
+        return;
+    }
+    m_executor->run(count, [&](std::size_t index) {
+        m_gate->pass();
+        fn(index);
+    });
+}
+
+std::size_t TileRenderer::tileCount(int width, int height) const {
+    return MakeTiles(width, height, m_settings.tileSize, m_settings.order).size();
+}
+
+bool TileRenderer::runTiles(int width, int height, const TileFunction& renderTile, bool cancellable, bool recordStats) {
+    std::vector<Tile> tiles = MakeTiles(width, height, m_settings.tileSize, m_settings.order);
+    if (!m_pixelOrder.empty()) {
+        for (Tile& tile : tiles) tile.pixelOrder = &m_pixelOrder;
+    }
+
+    if (recordStats && m_tileCosts.size() != tiles.size()) {
+        m_tileCosts.assign(tiles.size(), 0.0);
+    }
+    std::vector<std::size_t> order = dispatchOrder(tiles.size());
+    bool remapped = !order.empty();
+
+    // firstTouch (recordStats == false) initialise toute l'image, même hors du shard.
+    if (m_shardCount > 1 && (cancellable || recordStats)) {
+        if (!remapped) {
+            order.resize(tiles.size());
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            remapped = true;
+        }
+        order.erase(std::remove_if(order.begin(), order.end(), [&](std::size_t index) {
+            return !ownsTile(static_cast<int>(index));
+        }), order.end());
+    }
+    const std::size_t taskCount = remapped ? order.size() : tiles.size();
+
+    const bool finalPass = recordStats && m_finalPass;
+    const bool countPixels = finalPass && m_countPixels;
+    if (recordStats) {
+        m_finalPass = false;
+    }
+
+    std::atomic<bool> skipped{false};
+    m_executor->run(taskCount, [&](std::size_t task) {
+        // firstTouch n'est pas retenu : l'image doit exister avant que le rendu ne reprenne.
+        if (m_gate && recordStats) {
+            m_gate->pass();
+        }
+        if (cancellable && isCancelled()) {
+            skipped.store(true, std::memory_order_relaxed);
+            return;
+        }
+        const std::size_t index = remapped ? order[task] : task;
+        if (!recordStats) {
+            renderTile(tiles[index]);
+            return;
+        }
+        // Chaque tuile n'est rendue que par un worker : pas de course sur m_tileCosts[index].
+        const auto start = std::chrono::steady_clock::now();
+        renderTile(tiles[index]);
+        m_tileCosts[index] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (finalPass) {
+            const Tile& tile = tiles[index];
+            if (countPixels) {
+                stats::CountPixels(static_cast<std::uint64_t>(tile.x1 - tile.x0) * static_cast<std::uint64_t>(tile.y1 - tile.y0));
+            }
+            if (m_tileListener) m_tileListener(tile);
+        }
+    }, recordStats);
+    return !skipped.load(std::memory_order_relaxed);
+}
+
+// Le pool donne au worker w le bloc de tâches [n*w/W, n*(w+1)/W), dépilé dans l'ordre croissant.
+// (Avec un seul worker, comme en série, c'est simplement l'ordre des coûts décroissants.)
+// Les tuiles triées par coût décroissant sont distribuées à tour de rôle dans ces blocs :
+// chaque worker commence par sa part des tuiles les plus chères, les voleurs prennent les moins chères.
+std::vector<std::size_t> TileRenderer::dispatchOrder(std::size_t tileCount) const {
+    if (m_tileCostHint.size() != tileCount || tileCount == 0) {
+        return {};
+    }
+
+    std::vector<std::size_t> byCost(tileCount);
+    std::iota(byCost.begin(), byCost.end(), std::size_t(0));
+    std::stable_sort(byCost.begin(), byCost.end(), [&](std::size_t a, std::size_t b) {
+        return m_tileCostHint[a] > m_tileCostHint[b];
+    });
+
+    const std::size_t workerCount = m_executor->concurrency();
+    std::vector<std::size_t> next(workerCount);
+    for (std::size_t w = 0; w < workerCount; ++w) next[w] = tileCount * w / workerCount;
+
+    std::vector<std::size_t> order(tileCount);
+    std::size_t worker = 0;
+    for (std::size_t tile : byCost) {
+        // Blocs de tailles inégales : on saute ceux qui sont déjà pleins.
+        while (next[worker] == tileCount * (worker + 1) / workerCount) {
+            worker = (worker + 1) % workerCount;
+        }
+        order[next[worker]++] = tile;
+        worker = (worker + 1) % workerCount;
+    }
+    return order;
+}
+
+void TileRenderer::setShard(unsigned index, unsigned count) {
+    if (count == 0 || index >= count) {
+        throw std::invalid_argument("TileRenderer: shard index must be in [0, count)");
+    }
+    m_shardIndex = index;
+    m_shardCount = count;
+}
+
+bool TileRenderer::ownsTile(int tileIndex) const noexcept {
+    return static_cast<unsigned>(tileIndex) % m_shardCount == m_shardIndex;
+}
+
+void TileRenderer::setTileListener(TileFunction listener) {
+    m_tileListener = std::move(listener);
+}
+
+void TileRenderer::beginFinalPass(bool countPixels) noexcept {
+    m_finalPass = true;
+    m_countPixels = countPixels;
+}
+
+const std::vector<double>& TileRenderer::tileCosts() const noexcept {
+    return m_tileCosts;
+}
+
+void TileRenderer::resetTileCosts() {
+    m_tileCosts.clear();
+}
+
+void TileRenderer::setTileCostHint(std::vector<double> costs) {
+    m_tileCostHint = std::move(costs);
+}
+
+std::vector<WorkerStats> TileRenderer::schedulerStats() const {
+    return m_executor->stats();
+}
+
+void TileRenderer::resetSchedulerStats() {
+    m_executor->resetStats();
+}
+
+} // namespace rayrender
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "CancellationToken.hpp"
+#include "Executor.hpp"
+#include "ThreadPool.hpp"
+#include "TileGate.hpp"
+#include "Topology.hpp"
+#include "TraversalOrder.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rayrender {
+
+// Rectangle de pixels [x0, x1) x [y0, y1) rendu d'un seul tenant par un worker.
+// index est la position de la tuile dans l'ordre de parcours.
+struct Tile {
+    int index;
+    int x0, y0;
+    int x1, y1;
+    const std::vector<PixelOffset>* pixelOrder = nullptr;  // nullptr : ligne par ligne
+};
+
+// Appelle fn(x, y) pour chaque pixel de la tuile, dans l'ordre de parcours choisi.
+template <typename Fn>
+inline void ForEachPixel(const Tile& tile, Fn&& fn) {
+    if (!tile.pixelOrder) {
+        for (int y = tile.y0; y < tile.y1; ++y) {
+            for (int x = tile.x0; x < tile.x1; ++x) {
+                fn(x, y);
+            }
+        }
+        return;
+    }
+
+    for (const PixelOffset& offset : *tile.pixelOrder) {
+        const int x = tile.x0 + offset.x;
+        const int y = tile.y0 + offset.y;
+        if (x < tile.x1 && y < tile.y1) {
+            fn(x, y);
+        }
+    }
+}
+
+struct RenderSettings {
+    unsigned threads = 0;   // 0 = tous les threads matériels
+    int tileSize = 32;      // Côté des tuiles en pixels
+    AffinityMode affinity = AffinityMode::None;
+    TraversalOrder order = TraversalOrder::Tiled;
+    ExecutorKind executor = ExecutorKind::ThreadPool;
+};
+
+// Découpe l'image en tuiles, rangées dans l'ordre de parcours :
+// une tuile par ligne pour Scanline, des carrés de tileSize (tronqués au bord) sinon.
+// Pour Morton et Hilbert, des tuiles proches dans la liste sont voisines à l'écran.
+std::vector<Tile> MakeTiles(int width, int height, int tileSize, TraversalOrder order = TraversalOrder::Tiled);
+
+// Répartit les tuiles d'une image sur un moteur d'exécution (par défaut, un pool de threads à vol de travail).
+// Chaque tuile est rendue par un seul worker : deux workers n'écrivent jamais le même pixel.
+class TileRenderer {
+public:
+    using TileFunction = std::function<void(const Tile& tile)>;
+
+    explicit TileRenderer(const RenderSettings& settings = RenderSettings());
+
+    const RenderSettings& settings() const noexcept;
+    unsigned threadCount() const noexcept;
+    const CpuTopology& topology() const noexcept;
+    const std::vector<int>& workerCpus() const noexcept;
+
+    // Change l'ordre de parcours des prochains render() sans recréer les workers.
+    void setTraversalOrder(TraversalOrder order);
+
+    // Rend toutes les tuiles, sauf celles qui n'ont pas commencé avant l'annulation du jeton.
+    // Retourne true si toutes les tuiles ont été rendues.
+    bool render(int width, int height, const TileFunction& renderTile);
+
+    // Rend toutes les tuiles sans consulter le jeton (ex. : résolution finale d'une image interrompue).
+    void renderAll(int width, int height, const TileFunction& renderTile);
+
+    // Exécute fn(0..count-1) sur les workers, sans découpage en tuiles ni annulation
+    // (ex. : morceaux d'échantillons d'une petite image). fn consulte isCancelled() s'il le souhaite.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t index)>& fn);
+
+    // Nombre de tuiles (et borne des Tile::index) pour une image de cette taille.
+    std::size_t tileCount(int width, int height) const;
+
+    // Jeton consulté avant chaque tuile (nullptr : pas d'annulation). Le renderer ne le possède pas.
+    void setCancellationToken(const CancellationToken* token) noexcept;
+    const CancellationToken* cancellationToken() const noexcept;
+    bool isCancelled() const noexcept;
+
+    // Barrière franchie avant chaque tuile et chaque tâche de parallelFor (nullptr : aucune).
+    // Fermée, elle suspend le rendu en cours entre deux tuiles (préemption) ; le renderer ne la possède pas.
+    void setTileGate(const TileGate* gate) noexcept;
+
+    // Rendu partagé entre plusieurs processus : seules les tuiles dont Tile::index % count == index
+    // sont rendues (index dans [0, count)). Ne dépend que du découpage : un shard peut être relancé seul.
+    void setShard(unsigned index, unsigned count);
+    bool ownsTile(int tileIndex) const noexcept;
+
+    // Temps de rendu (s) de chaque tuile, indexé par Tile::index et cumulé sur les render()
+    // depuis le dernier reset. Remis à zéro automatiquement si le nombre de tuiles change.
+    const std::vector<double>& tileCosts() const noexcept;
+    void resetTileCosts();
+
+    // Coûts connus d'un rendu précédent (même découpage) : les tuiles les plus chères sont
+    // distribuées en premier, à tour de rôle entre les workers, pour raccourcir la fin du rendu.
+    // Ignoré si la taille ne correspond pas au nombre de tuiles. Vide : ordre de parcours.
+    void setTileCostHint(std::vector<double> costs);
+
+    // Appelé par le worker après chaque tuile de la passe finale (pixels définitifs),
+    // par exemple pour encoder l'image au fil du rendu. Vide : pas d'appel.
+    void setTileListener(TileFunction listener);
+    // Le prochain render()/renderAll() écrit les valeurs définitives de ses pixels.
+    // Les fonctions de rendu l'appellent juste avant leur dernière passe.
+    // countPixels == false : la fonction de rendu compte elle-même ses pixels (stats::CountPixels),
+    // par exemple quand des tuiles de cette passe n'ont reçu aucun échantillon.
+    void beginFinalPass(bool countPixels = true) noexcept;
+
+    // Première écriture de la mémoire de chaque tuile, par le worker qui la rendra ensuite.
+    // Avec des workers épinglés, les pages de l'image sont ainsi allouées sur leur noeud NUMA.
+    void firstTouch(int width, int height, const TileFunction& touchTile);
+
+    ExecutorKind executorKind() const noexcept;
+
+    // Vols et temps d'inactivité par worker, cumulés sur tous les render() depuis le dernier reset.
+    // Vide avec par_unseq.
+    std::vector<WorkerStats> schedulerStats() const;
+    void resetSchedulerStats();
+
+private:
+    bool runTiles(int width, int height, const TileFunction& renderTile, bool cancellable, bool recordStats);
+    std::vector<std::size_t> dispatchOrder(std::size_t tileCount) const;
+
+    RenderSettings m_settings;
+    CpuTopology m_topology;
+    std::vector<int> m_workerCpus;
+    std::vector<PixelOffset> m_pixelOrder;  // Ordre des pixels dans une tuile (Morton/Hilbert)
+    const CancellationToken* m_cancellation = nullptr;
+    const TileGate* m_gate = nullptr;
+    std::vector<double> m_tileCosts;
+    std::vector<double> m_tileCostHint;
+    TileFunction m_tileListener;
+    bool m_finalPass = false;
+    bool m_countPixels = true;
+    unsigned m_shardIndex = 0;
+    unsigned m_shardCount = 1;
+    std::unique_ptr<Executor> m_executor;
+};
+
+} // namespace rayrender
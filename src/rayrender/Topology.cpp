@@ -0,0 +1,196 @@
+#include "Topology.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace rayrender {
+
+namespace {
+
+// Décode une liste de CPUs au format du noyau, par ex. "0-3,8,10-11".
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        const std::size_t dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+// Compacte une liste triée de CPUs pour l'affichage ("0-3,8").
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream out;
+    for (std::size_t i = 0; i < cpus.size();) {
+        std::size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (i > 0) out << ",";
+        out << cpus[i];
+        if (j > i) out << "-" << cpus[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+} // namespace
+
+AffinityMode ParseAffinityMode(const std::string& name) {
+    if (name == "none") return AffinityMode::None;
+    if (name == "compact") return AffinityMode::Compact;
+    if (name == "scatter") return AffinityMode::Scatter;
+    throw std::invalid_argument("Unknown affinity mode: " + name + " (expected none, compact or scatter)");
+}
+
+const char* AffinityModeName(AffinityMode mode) noexcept {
+    switch (mode) {
+        case AffinityMode::Compact: return "compact";
+        case AffinityMode::Scatter: return "scatter";
+        case AffinityMode::None: break;
+    }
+    return "none";
+}
+
+CpuTopology CpuTopology::Detect() {
+    CpuTopology topology;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto isAllowed = [&](int cpu) {
+        return !haveMask || (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+    };
+
+    if (DIR* dir = opendir("/sys/devices/system/node")) {
+        while (dirent* entry = readdir(dir)) {
+            const std::string name = entry->d_name;
+            if (name.rfind("node", 0) != 0 || name.size() <= 4
+                || !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+
+            std::ifstream list("/sys/devices/system/node/" + name + "/cpulist");
+            std::string text;
+            std::getline(list, text);
+
+            NumaNode node;
+            node.id = std::stoi(name.substr(4));
+            for (int cpu : parseCpuList(text)) {
+                if (isAllowed(cpu)) node.cpus.push_back(cpu);
+            }
+            if (!node.cpus.empty()) topology.nodes.push_back(node);
+        }
+        closedir(dir);
+    }
+
+    if (topology.nodes.empty() && haveMask) {
+        NumaNode node{0, {}};
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) node.cpus.push_back(cpu);
+        }
+        if (!node.cpus.empty()) topology.nodes.push_back(node);
+    }
+#endif
+
+    if (topology.nodes.empty()) {
+        NumaNode node{0, {}};
+        const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned cpu = 0; cpu < hardware; ++cpu) node.cpus.push_back(static_cast<int>(cpu));
+        topology.nodes.push_back(node);
+    }
+
+    std::sort(topology.nodes.begin(), topology.nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return topology;
+}
+
+std::size_t CpuTopology::cpuCount() const noexcept {
+    std::size_t count = 0;
+    for (const auto& node : nodes) count += node.cpus.size();
+    return count;
+}
+
+int CpuTopology::nodeOfCpu(int cpu) const noexcept {
+    for (const auto& node : nodes) {
+        if (std::find(node.cpus.begin(), node.cpus.end(), cpu) != node.cpus.end()) return node.id;
+    }
+    return -1;
+}
+
+std::vector<int> AssignCpus(const CpuTopology& topology, unsigned threadCount, AffinityMode mode) {
+    std::vector<int> cpus;
+    if (mode == AffinityMode::None || topology.cpuCount() == 0) {
+        return cpus;
+    }
+
+    std::vector<int> order;
+    order.reserve(topology.cpuCount());
+    if (mode == AffinityMode::Compact) {
+        for (const auto& node : topology.nodes) {
+            order.insert(order.end(), node.cpus.begin(), node.cpus.end());
+        }
+    } else {
+        // Scatter : premier CPU de chaque noeud, puis le deuxième de chaque noeud, etc.
+        for (std::size_t rank = 0; order.size() < topology.cpuCount(); ++rank) {
+            for (const auto& node : topology.nodes) {
+                if (rank < node.cpus.size()) order.push_back(node.cpus[rank]);
+            }
+        }
+    }
+
+    cpus.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        cpus.push_back(order[i % order.size()]);
+    }
+    return cpus;
+}
+
+bool PinCurrentThread(int cpu) noexcept {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+void PrintTopology(std::ostream& out, const CpuTopology& topology, AffinityMode mode, const std::vector<int>& workerCpus) {
+    out << "Topology: " << topology.nodes.size() << " NUMA node(s), " << topology.cpuCount() << " CPU(s)";
+    for (const auto& node : topology.nodes) {
+        out << "; node " << node.id << ": " << formatCpuList(node.cpus);
+    }
+    out << "\nAffinity: " << AffinityModeName(mode);
+    if (!workerCpus.empty()) {
+        out << " (workers -> cpus";
+        for (std::size_t i = 0; i < workerCpus.size(); ++i) {
+            out << (i == 0 ? " " : ",") << workerCpus[i];
+        }
+        out << ")";
+    }
+    out << "\n";
+}
+
+} // namespace rayrender
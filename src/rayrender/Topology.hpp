@@ -0,0 +1,45 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rayrender {
+
+// Placement des workers sur les coeurs.
+enum class AffinityMode {
+    None,     // Pas d'épinglage : l'ordonnanceur de l'OS décide
+    Compact,  // Remplit les coeurs d'un noeud NUMA avant de passer au suivant
+    Scatter   // Répartit les workers à tour de rôle sur les noeuds NUMA
+};
+
+// Lit "none", "compact" ou "scatter" ; lève std::invalid_argument sinon.
+AffinityMode ParseAffinityMode(const std::string& name);
+const char* AffinityModeName(AffinityMode mode) noexcept;
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;  // CPUs du noeud autorisés pour le processus
+};
+
+// Noeuds NUMA et CPUs utilisables par le processus.
+// Sous Linux, lu depuis /sys/devices/system/node et filtré par sched_getaffinity ;
+// ailleurs, un seul noeud contenant hardware_concurrency() CPUs.
+struct CpuTopology {
+    std::vector<NumaNode> nodes;
+
+    static CpuTopology Detect();
+
+    std::size_t cpuCount() const noexcept;
+    int nodeOfCpu(int cpu) const noexcept;
+};
+
+// CPU attribué à chaque worker selon le mode de placement (vide pour AffinityMode::None).
+std::vector<int> AssignCpus(const CpuTopology& topology, unsigned threadCount, AffinityMode mode);
+
+// Épingle le thread appelant sur un CPU. Retourne false si l'OS refuse ou ne le permet pas.
+bool PinCurrentThread(int cpu) noexcept;
+
+void PrintTopology(std::ostream& out, const CpuTopology& topology, AffinityMode mode, const std::vector<int>& workerCpus);
+
+} // namespace rayrender
@@ -0,0 +1,107 @@
+#include "TraversalOrder.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace rayrender {
+
+namespace {
+
+// Garde un bit sur deux : 0b1011 -> 0b11 (bits pairs du code de Morton).
+std::uint32_t compactBits(std::uint32_t v) noexcept {
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return v;
+}
+
+std::uint32_t nextPowerOfTwo(std::uint32_t v) noexcept {
+    std::uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+TraversalOrder ParseTraversalOrder(const std::string& name) {
+    if (name == "scanline") return TraversalOrder::Scanline;
+    if (name == "tiled") return TraversalOrder::Tiled;
+    if (name == "morton") return TraversalOrder::Morton;
+    if (name == "hilbert") return TraversalOrder::Hilbert;
+    throw std::invalid_argument("Unknown traversal order: " + name + " (expected scanline, tiled, morton or hilbert)");
+}
+
+const char* TraversalOrderName(TraversalOrder order) noexcept {
+    switch (order) {
+        case TraversalOrder::Scanline: return "scanline";
+        case TraversalOrder::Morton: return "morton";
+        case TraversalOrder::Hilbert: return "hilbert";
+        case TraversalOrder::Tiled: break;
+    }
+    return "tiled";
+}
+
+PixelOffset MortonPoint(std::uint32_t d) noexcept {
+    return PixelOffset{static_cast<std::uint16_t>(compactBits(d)),
+                       static_cast<std::uint16_t>(compactBits(d >> 1))};
+}
+
+// Algorithme classique "d2xy" : on descend les niveaux de la courbe en appliquant
+// la rotation/réflexion de chaque quadrant.
+PixelOffset HilbertPoint(std::uint32_t side, std::uint32_t d) noexcept {
+    std::uint32_t x = 0;
+    std::uint32_t y = 0;
+    std::uint32_t t = d;
+    for (std::uint32_t s = 1; s < side; s <<= 1) {
+        const std::uint32_t rx = 1u & (t / 2);
+        const std::uint32_t ry = 1u & (t ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+        x += s * rx;
+        y += s * ry;
+        t /= 4;
+    }
+    return PixelOffset{static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y)};
+}
+
+std::vector<PixelOffset> CurveOrder(TraversalOrder order, int width, int height) {
+    std::vector<PixelOffset> points;
+    if (width <= 0 || height <= 0) {
+        return points;
+    }
+    if (width > 0xFFFF || height > 0xFFFF) {
+        throw std::invalid_argument("CurveOrder: grid too large");
+    }
+    points.reserve(static_cast<std::size_t>(width) * height);
+
+    if (order == TraversalOrder::Scanline || order == TraversalOrder::Tiled) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                points.push_back(PixelOffset{static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y)});
+            }
+        }
+        return points;
+    }
+
+    // La courbe couvre le carré puissance de 2 englobant ; on saute les points hors grille.
+    const std::uint32_t side = nextPowerOfTwo(static_cast<std::uint32_t>(width > height ? width : height));
+    const std::uint64_t count = static_cast<std::uint64_t>(side) * side;
+    for (std::uint64_t d = 0; d < count; ++d) {
+        const PixelOffset p = order == TraversalOrder::Morton
+            ? MortonPoint(static_cast<std::uint32_t>(d))
+            : HilbertPoint(side, static_cast<std::uint32_t>(d));
+        if (p.x < width && p.y < height) {
+            points.push_back(p);
+        }
+    }
+    return points;
+}
+
+} // namespace rayrender
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rayrender {
+
+// Ordre de parcours des pixels : ordre des tuiles dans la file de rendu
+// et ordre des pixels à l'intérieur d'une tuile.
+enum class TraversalOrder {
+    Scanline,  // Une tuile par ligne d'image, pixels de gauche à droite
+    Tiled,     // Tuiles carrées ligne par ligne, pixels ligne par ligne dans la tuile
+    Morton,    // Tuiles et pixels le long d'une courbe de Morton (ordre Z)
+    Hilbert    // Tuiles et pixels le long d'une courbe de Hilbert
+};
+
+// Lit "scanline", "tiled", "morton" ou "hilbert" ; lève std::invalid_argument sinon.
+TraversalOrder ParseTraversalOrder(const std::string& name);
+const char* TraversalOrderName(TraversalOrder order) noexcept;
+
+constexpr TraversalOrder AllTraversalOrders[] = {
+    TraversalOrder::Scanline,
+    TraversalOrder::Tiled,
+    TraversalOrder::Morton,
+    TraversalOrder::Hilbert,
+};
+
+struct PixelOffset {
+    std::uint16_t x;
+    std::uint16_t y;
+};
+
+// Coordonnées du d-ième point d'une courbe couvrant une grille side x side (side puissance de 2).
+PixelOffset MortonPoint(std::uint32_t d) noexcept;
+PixelOffset HilbertPoint(std::uint32_t side, std::uint32_t d) noexcept;
+
+// Tous les points de [0, width) x [0, height) dans l'ordre de parcours.
+std::vector<PixelOffset> CurveOrder(TraversalOrder order, int width, int height);
+
+} // namespace rayrender
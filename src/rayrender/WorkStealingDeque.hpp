@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace rayrender {
+
+// Deque de Chase-Lev à capacité fixe (version C11 de Lê et al., PPoPP 2013).
+// Le propriétaire empile et dépile par le bas (LIFO), les voleurs prennent par le haut (FIFO).
+// Aucun verrou : seules les opérations sur le dernier élément se disputent top par CAS.
+class WorkStealingDeque {
+public:
+    using Value = std::size_t;
+
+    WorkStealingDeque() = default;
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Vide la deque et garantit au moins `capacity` emplacements.
+    // À n'appeler que lorsqu'aucun autre thread n'y accède.
+    void reset(std::size_t capacity) {
+        std::size_t rounded = 1;
+        while (rounded < capacity) rounded <<= 1;
+        if (rounded > m_capacity) {
+            m_buffer = std::make_unique<std::atomic<Value>[]>(rounded);
+            m_capacity = rounded;
+        }
+        m_mask = m_capacity - 1;
+        m_top.store(0, std::memory_order_relaxed);
+        m_bottom.store(0, std::memory_order_relaxed);
+    }
+
+    // Propriétaire uniquement. Retourne false si la deque est pleine.
+    bool push(Value value) noexcept {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<std::int64_t>(m_capacity)) {
+            return false;
+        }
+        m_buffer[static_cast<std::size_t>(b) & m_mask].store(value, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Propriétaire uniquement.
+    std::optional<Value> pop() noexcept {
+        const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        Value value = m_buffer[static_cast<std::size_t>(b) & m_mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Dernier élément : on le dispute aux voleurs.
+            const bool won = m_top.compare_exchange_strong(t, t + 1,
+                                                           std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won) return std::nullopt;
+        }
+        return value;
+    }
+
+    // N'importe quel thread. Échoue si la deque est vide ou si un autre thread a gagné la course.
+    std::optional<Value> steal() noexcept {
+        std::int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return std::nullopt;
+        }
+
+        Value value = m_buffer[static_cast<std::size_t>(t) & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    // top et bottom sur des lignes de cache séparées : l'un est écrit par les voleurs, l'autre par le propriétaire.
+    alignas(64) std::atomic<std::int64_t> m_top{0};
+    alignas(64) std::atomic<std::int64_t> m_bottom{0};
+    alignas(64) std::unique_ptr<std::atomic<Value>[]> m_buffer;
+    std::size_t m_capacity = 0;
+    std::size_t m_mask = 0;
+};
+
+} // namespace rayrender
@@ -0,0 +1,40 @@
+#include "Camera.hpp"
+#include "../rayrender/RenderStats.hpp"
+
+namespace rayscene {
+
+using math::Ray;
+using math::Real;
+using math::Vec3;
+
+Camera::Camera(const Vec3& origin, int width, int height, Real focalLength) noexcept
+    : m_origin(origin)
+    , m_width(width)
+    , m_height(height)
+    , m_aspect(height > 0 ? Real(width) / Real(height) : Real(1))
+    , m_focalLength(focalLength)
+{}
+
+const Vec3& Camera::origin() const noexcept {
+    return m_origin;
+}
+
+Real Camera::aspect() const noexcept {
+    return m_aspect;
+}
+
+Real Camera::focalLength() const noexcept {
+    return m_focalLength;
+}
+
+Ray Camera::generateRay(Real sampleX, Real sampleY) const noexcept {
+    rayrender::stats::CountRay(rayrender::RayKind::Primary);
+    const Real screenX = ((Real(2.0) * sampleX / m_width) - Real(1.0)) * m_aspect;
+    const Real screenY = (Real(2.0) * sampleY / m_height) - Real(1.0);
+
+    Vec3 rayDirection(screenX, -screenY, m_focalLength);
+    rayDirection = rayDirection.normalized();
+    return Ray(m_origin, rayDirection);
+}
+
+} // namespace rayscene
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../raymath/Vec3.hpp"
+#include "../raymath/Ray.hpp"
+
+namespace rayscene {
+
+// Caméra sténopé utilisée par les passes de rendu : regarde vers +Z depuis origin,
+// l'écran est à focalLength de l'origine et couvre [-aspect, aspect] x [-1, 1].
+class Camera {
+public:
+    Camera(const math::Vec3& origin, int width, int height, math::Real focalLength = 4.0) noexcept;
+
+    const math::Vec3& origin() const noexcept;
+    math::Real aspect() const noexcept;
+    math::Real focalLength() const noexcept;
+
+    // Rayon primaire passant par le point (sampleX, sampleY) en coordonnées pixel.
+    math::Ray generateRay(math::Real sampleX, math::Real sampleY) const noexcept;
+
+private:
+    math::Vec3 m_origin;
+    int m_width;
+    int m_height;
+    math::Real m_aspect;
+    math::Real m_focalLength;
+};
+
+} // namespace rayscene
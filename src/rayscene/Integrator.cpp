@@ -0,0 +1,215 @@
+#include "Integrator.hpp"
+#include "Plane.hpp"
+#include "../raymath/Random.hpp"
+#include "../rayrender/RenderStats.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rayscene {
+
+namespace {
+
+// Nombre maximal de morceaux d'échantillons, et mémoire totale des tampons partiels.
+constexpr int MaxSampleChunks = 64;
+constexpr std::size_t SampleChunkBudgetBytes = std::size_t(256) << 20;
+
+} // namespace
+
+using math::HitInfo;
+using math::Ray;
+using math::Real;
+using math::Vec3;
+
+Integrator::Integrator(const SphereBvh& spheres, const Plane& plane, Light light, Color background)
+    : m_spheres(spheres)
+    , m_plane(plane)
+    , m_light(light)
+    , m_background(background.R(), background.G(), background.B())
+{}
+
+Vec3 Integrator::Trace(const Ray& ray, const CameraSphereTable& cameraSpheres) const noexcept {
+    return ShadePrimary(ray, cameraSpheres.origin(), m_spheres.closestIntersection(ray, cameraSpheres));
+}
+
+Vec3 Integrator::ShadePrimary(const Ray& ray, const Vec3& camOrigin, const std::optional<SphereIntersection>& closest) const noexcept {
+    const Real closest_t = closest ? closest->t : std::numeric_limits<Real>::infinity();
+
+    const auto planeHit = m_plane.intersect(ray);
+    if (planeHit && planeHit->t < closest_t) {
+        return m_plane.shade(ray, *planeHit, m_light, m_spheres, camOrigin);
+    }
+
+    // Attributs de surface seulement si la sphère l'emporte sur le plan.
+    if (closest) {
+        const SphereHit hit = m_spheres.surfaceInteraction(ray, *closest);
+        return hit.sphere->shade(hit.hit, ray, m_light, m_spheres, camOrigin, m_plane);
+    }
+
+    return m_background;
+}
+
+int Integrator::Render(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const {
+    const int width = static_cast<int>(image.Width());
+    const int height = static_cast<int>(image.Height());
+    if (width <= 0 || height <= 0 || echantillonsNumber <= 0) {
+        return 0;
+    }
+
+    const rayrender::CancellationToken* token = renderer.cancellationToken();
+    if (token && token->hasDeadline()) {
+        return RenderProgressive(image, renderer, camera, echantillonsNumber, seed);
+    }
+
+    const CameraSphereTable cameraSpheres(m_spheres, camera.origin());
+    const SphereTileBins bins(m_spheres, cameraSpheres, camera, renderer, width, height);
+
+    renderer.beginFinalPass();
+    const bool complete = renderer.render(width, height, [&](const rayrender::Tile& tile) {
+        rayrender::ForEachPixel(tile, [&](int x, int y) {
+            Vec3 accumulatorColor(0, 0, 0);
+            const std::uint64_t pixelIndex = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
+
+            for (int echantillon = 0; echantillon < echantillonsNumber; ++echantillon) {
+                math::SampleRng rng(seed, pixelIndex, static_cast<std::uint64_t>(echantillon));
+                Real sampleX = Real(x) + rng.nextReal();
+                Real sampleY = Real(y) + rng.nextReal();
+
+                const Ray ray = camera.generateRay(sampleX, sampleY);
+                accumulatorColor += ShadePrimary(ray, camera.origin(), bins.closestIntersection(tile, ray));
+            }
+
+            const Vec3 finalColor = accumulatorColor / Real(echantillonsNumber);
+            image.SetPixel(static_cast<unsigned>(x), static_cast<unsigned>(y),
+                           Color(ClampColor(finalColor.x), ClampColor(finalColor.y), ClampColor(finalColor.z)));
+        });
+    });
+
+    return complete ? echantillonsNumber : 0;
+}
+
+// Une passe = un échantillon de plus pour chaque pixel. Les sommes sont faites dans le même
+// ordre que Render(), donc une image menée à terme est identique au bit près.
+int Integrator::RenderProgressive(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const {
+    const int width = static_cast<int>(image.Width());
+    const int height = static_cast<int>(image.Height());
+
+    std::vector<Vec3> accumulation(static_cast<std::size_t>(width) * height, Vec3(0, 0, 0));
+    std::vector<int> tileSamples(renderer.tileCount(width, height), 0);
+    const CameraSphereTable cameraSpheres(m_spheres, camera.origin());
+    const SphereTileBins bins(m_spheres, cameraSpheres, camera, renderer, width, height);
+
+    for (int echantillon = 0; echantillon < echantillonsNumber; ++echantillon) {
+        renderer.render(width, height, [&](const rayrender::Tile& tile) {
+            rayrender::ForEachPixel(tile, [&](int x, int y) {
+                const std::uint64_t pixelIndex = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
+                math::SampleRng rng(seed, pixelIndex, static_cast<std::uint64_t>(echantillon));
+                Real sampleX = Real(x) + rng.nextReal();
+                Real sampleY = Real(y) + rng.nextReal();
+
+                const Ray ray = camera.generateRay(sampleX, sampleY);
+                accumulation[pixelIndex] += ShadePrimary(ray, camera.origin(), bins.closestIntersection(tile, ray));
+            });
+            tileSamples[tile.index] = echantillon + 1;
+        });
+
+        if (renderer.isCancelled()) {
+            break;
+        }
+    }
+
+    // Résolution : les tuiles sans aucun échantillon gardent le fond de l'image et ne comptent
+    // pas comme pixels rendus.
+    renderer.beginFinalPass(false);
+    renderer.renderAll(width, height, [&](const rayrender::Tile& tile) {
+        const int samples = tileSamples[tile.index];
+        if (samples == 0) {
+            return;
+        }
+        rayrender::stats::CountPixels(static_cast<std::uint64_t>(tile.x1 - tile.x0) * static_cast<std::uint64_t>(tile.y1 - tile.y0));
+        rayrender::ForEachPixel(tile, [&](int x, int y) {
+            const Vec3 finalColor = accumulation[static_cast<std::size_t>(y) * width + x] / Real(samples);
+            image.SetPixel(static_cast<unsigned>(x), static_cast<unsigned>(y),
+                           Color(ClampColor(finalColor.x), ClampColor(finalColor.y), ClampColor(finalColor.z)));
+        });
+    });
+
+    // Avec un shard, seules les tuiles qu'il possède comptent.
+    int minSamples = echantillonsNumber;
+    for (std::size_t index = 0; index < tileSamples.size(); ++index) {
+        if (renderer.ownsTile(static_cast<int>(index))) {
+            minSamples = std::min(minSamples, tileSamples[index]);
+        }
+    }
+    return minSamples;
+}
+
+int Integrator::RenderSampleParallel(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const {
+    const int width = static_cast<int>(image.Width());
+    const int height = static_cast<int>(image.Height());
+    if (width <= 0 || height <= 0 || echantillonsNumber <= 0) {
+        return 0;
+    }
+
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * height;
+    const std::size_t bufferBytes = pixelCount * sizeof(Vec3);
+    const int chunkCount = static_cast<int>(std::max<std::size_t>(1,
+        std::min<std::size_t>({static_cast<std::size_t>(MaxSampleChunks),
+                               static_cast<std::size_t>(echantillonsNumber),
+                               SampleChunkBudgetBytes / bufferBytes})));
+
+    // Chaque tampon est alloué par le worker qui le remplit.
+    std::vector<std::vector<Vec3>> partials(chunkCount);
+    std::vector<int> chunkSamples(chunkCount, 0);
+    const CameraSphereTable cameraSpheres(m_spheres, camera.origin());
+
+    renderer.parallelFor(static_cast<std::size_t>(chunkCount), [&](std::size_t chunk) {
+        const int first = static_cast<int>(static_cast<long long>(echantillonsNumber) * chunk / chunkCount);
+        const int last = static_cast<int>(static_cast<long long>(echantillonsNumber) * (chunk + 1) / chunkCount);
+
+        std::vector<Vec3>& partial = partials[chunk];
+        partial.assign(pixelCount, Vec3(0, 0, 0));
+
+        for (int echantillon = first; echantillon < last; ++echantillon) {
+            if (renderer.isCancelled()) {
+                break;
+            }
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    const std::uint64_t pixelIndex = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
+                    math::SampleRng rng(seed, pixelIndex, static_cast<std::uint64_t>(echantillon));
+                    Real sampleX = Real(x) + rng.nextReal();
+                    Real sampleY = Real(y) + rng.nextReal();
+
+                    partial[pixelIndex] += Trace(camera.generateRay(sampleX, sampleY), cameraSpheres);
+                }
+            }
+            chunkSamples[chunk] = echantillon - first + 1;
+        }
+    });
+
+    int samples = 0;
+    for (int count : chunkSamples) samples += count;
+    if (samples == 0) {
+        return 0;
+    }
+
+    // Réduction : même ordre de sommation (morceau 0, 1, ...) quel que soit le worker.
+    renderer.beginFinalPass();
+    renderer.renderAll(width, height, [&](const rayrender::Tile& tile) {
+        rayrender::ForEachPixel(tile, [&](int x, int y) {
+            const std::size_t pixelIndex = static_cast<std::size_t>(y) * width + x;
+            Vec3 sum(0, 0, 0);
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                if (chunkSamples[chunk] > 0) sum += partials[chunk][pixelIndex];
+            }
+            const Vec3 finalColor = sum / Real(samples);
+            image.SetPixel(static_cast<unsigned>(x), static_cast<unsigned>(y),
+                           Color(ClampColor(finalColor.x), ClampColor(finalColor.y), ClampColor(finalColor.z)));
+        });
+    });
+
+    return samples;
+}
+
+} // namespace rayscene
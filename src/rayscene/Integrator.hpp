@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../raymath/Color.hpp"
+#include "../raymath/Vec3.hpp"
+#include "../raymath/Ray.hpp"
+#include "../rayimage/Image.hpp"
+#include "../rayrender/TileRenderer.hpp"
+#include "Camera.hpp"
+#include "Light.hpp"
+#include "Sphere.hpp"
+#include "SphereBvh.hpp"
+#include "SphereTileBins.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Plane;
+
+namespace rayscene {
+
+// Rendu en une seule passe : chaque échantillon caméra est lancé une fois contre
+// les sphères et le plan, et seul l'impact le plus proche est ombré.
+// Remplace l'enchaînement Plane::DrawPlane puis Sphere::DrawSphere.
+class Integrator {
+public:
+    Integrator(const SphereBvh& spheres, const Plane& plane, Light light, Color background);
+
+    // Le jitter de chaque échantillon dépend uniquement de (seed, pixel, échantillon) :
+    // même seed, même image, quel que soit le nombre de threads.
+    // Si le jeton d'annulation du renderer a une échéance, le rendu se fait par passes d'un
+    // échantillon par pixel ; à l'annulation, l'image garde la moyenne des passes terminées.
+    // Sans échéance, le rendu se fait en une passe : une annulation explicite saute les tuiles
+    // pas encore commencées, qui gardent le fond.
+    // Retourne le nombre d'échantillons obtenus par le pixel le moins bien servi.
+    int Render(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const;
+
+    // Pour les petites images très échantillonnées, où il y a moins de tuiles que de workers :
+    // les échantillons sont découpés en morceaux dont chacun accumule toute l'image dans son
+    // propre tampon, puis les tampons sont sommés dans l'ordre des morceaux. Le découpage ne
+    // dépend que de la taille de l'image et du nombre d'échantillons, pas du nombre de threads.
+    // Retourne le nombre d'échantillons par pixel effectivement calculés.
+    int RenderSampleParallel(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const;
+
+    // Couleur non bornée d'un rayon primaire, issu de cameraSpheres.origin().
+    math::Vec3 Trace(const math::Ray& ray, const CameraSphereTable& cameraSpheres) const noexcept;
+
+private:
+    // Couleur d'un rayon primaire dont la sphère la plus proche (distance seule) est déjà connue.
+    math::Vec3 ShadePrimary(const math::Ray& ray, const math::Vec3& camOrigin, const std::optional<SphereIntersection>& closest) const noexcept;
+
+    int RenderProgressive(Image& image, rayrender::TileRenderer& renderer, const Camera& camera, int echantillonsNumber, std::uint64_t seed) const;
+
+    const SphereBvh& m_spheres;
+    const Plane& m_plane;
+    Light m_light;
+    math::Vec3 m_background;
+};
+
+} // namespace rayscene
@@ -0,0 +1,64 @@
+#include "Keyframes.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rayscene {
+
+math::Vec3 SampleTrack(const Track& track, double frame, const math::Vec3& fallback) {
+    if (track.empty()) {
+        return fallback;
+    }
+    if (frame <= track.front().frame) {
+        return track.front().value;
+    }
+    if (frame >= track.back().frame) {
+        return track.back().value;
+    }
+
+    // Première clé strictement après frame : l'intervalle [prev, next] contient frame.
+    const auto next = std::upper_bound(track.begin(), track.end(), frame, [](double f, const Keyframe& key) {
+        return f < key.frame;
+    });
+    const auto prev = next - 1;
+    const math::Real t = static_cast<math::Real>((frame - prev->frame) / (next->frame - prev->frame));
+    return prev->value + (next->value - prev->value) * t;
+}
+
+std::string FrameOutputPath(const std::string& pattern, int frame) {
+    const std::size_t first = pattern.find('#');
+    if (first == std::string::npos) {
+        return pattern;
+    }
+    const std::size_t last = pattern.find_first_not_of('#', first);
+    const std::size_t width = (last == std::string::npos ? pattern.size() : last) - first;
+
+    std::string number = std::to_string(frame);
+    if (number.size() < width) {
+        number.insert(0, width - number.size(), '0');
+    }
+    return pattern.substr(0, first) + number + pattern.substr(first + width);
+}
+
+SceneConfig FrameConfig(const SceneConfig& base, int frame) {
+    if (!base.animation) {
+        throw std::invalid_argument("FrameConfig: scene has no animation block");
+    }
+    const AnimationConfig& animation = *base.animation;
+
+    SceneConfig config = base;
+    config.animation.reset();
+    config.outputPath = FrameOutputPath(animation.outputPattern, frame);
+    config.camera.origin = SampleTrack(animation.camera, frame, base.camera.origin);
+    if (config.light) {
+        config.light->position = SampleTrack(animation.light, frame, base.light->position);
+    } else if (!animation.light.empty()) {
+        config.light = LightConfig{SampleTrack(animation.light, frame, math::Vec3())};
+    }
+    for (std::size_t i = 0; i < config.spheres.size() && i < animation.sphereCenters.size(); ++i) {
+        config.spheres[i].center = SampleTrack(animation.sphereCenters[i], frame, base.spheres[i].center);
+    }
+    return config;
+}
+
+} // namespace rayscene
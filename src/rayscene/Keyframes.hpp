@@ -0,0 +1,21 @@
+#pragma once
+
+#include "../raymath/Vec3.hpp"
+#include "SceneLoader.hpp"
+
+#include <string>
+
+namespace rayscene {
+
+// Valeur de la piste à l'image frame ; fallback si la piste n'a pas de clé.
+math::Vec3 SampleTrack(const Track& track, double frame, const math::Vec3& fallback);
+
+// Motif de sortie avec le numéro d'image à la place des '#' ("out_####.png", 12 -> "out_0012.png").
+// Seule la première suite de '#' est remplacée ; le numéro n'est jamais tronqué.
+std::string FrameOutputPath(const std::string& pattern, int frame);
+
+// Scène de l'image frame : pistes évaluées, sortie numérotée, sans bloc animation.
+// base doit avoir un bloc animation.
+SceneConfig FrameConfig(const SceneConfig& base, int frame);
+
+} // namespace rayscene
@@ -1,9 +1,12 @@
 #include "Plane.hpp"
 #include "../raymath/Ray.hpp"
 #include "../raymath/Vec3.hpp"
+#include "../raymath/Random.hpp"
 #include "../rayscene/Light.hpp"
 #include "../rayscene/Sphere.hpp"
+#include "../rayscene/Camera.hpp"
 #include "../rayshader/DiffuseShader.hpp"
+#include "../rayrender/RenderStats.hpp"
 #include <cmath>
 
 using namespace std;
@@ -14,6 +17,7 @@ Plane::Plane(array<Color, 2> colors, float posY, float tileSize)
 }
 
 std::optional<HitInfo> Plane::intersect(const Ray& ray) const noexcept {
+    rayrender::stats::CountPlaneTest();
     Real t = (posY - ray.origin().y) / ray.direction().y;
 
     if (t < RAY_MIN_T) {
@@ -37,78 +41,69 @@ Vec3 Plane::getColorAt(const Vec3& point) const noexcept {
     return Vec3(baseColor.R(), baseColor.G(), baseColor.B());
 }
 
-void Plane::DrawPlane(Image& image, const Vec3& camOrigin, int width, int height, const std::vector<rayscene::Sphere>& spheres, Light light, int echantillonsNumber) {
+Vec3 Plane::shade(const Ray& ray, const HitInfo& hit, Light light, const rayscene::SphereBvh& spheres, const Vec3& camOrigin) const noexcept {
+    int gridX = (int)floor(hit.point.x / tileSize);
+    int gridZ = (int)floor(hit.point.z / tileSize);
+
+    DiffuseShader shader;
+    float shadowFactor = shader.ShadowFactorPlane(hit, light, spheres);
+
+    bool isWhite = (gridX + gridZ) % 2 == 0;
+    Color baseColor = isWhite ? colors[0] : colors[1];
+
+    Vec3 shadedColor(
+        baseColor.R() * shadowFactor,
+        baseColor.G() * shadowFactor,
+        baseColor.B() * shadowFactor
+    );
+
+    Vec3 planeNormal(0, 1, 0);
+    Vec3 reflectDir = ray.direction().reflect(planeNormal);
+    Ray reflectRay(hit.point, reflectDir);
+    rayrender::stats::CountRay(rayrender::RayKind::Reflection);
+
+    if (const auto sphereHit = spheres.closestHit(reflectRay)) {
+        Vec3 sphereShadedColor = sphereHit->sphere->getShadedColor(sphereHit->hit, reflectRay, light, spheres, camOrigin, *this);
+        shadedColor = (shadedColor + (sphereShadedColor * sphereHit->sphere->reflectFactor())) * shadowFactor;
+    }
+
+    return shadedColor;
+}
+
+void Plane::DrawPlane(Image& image, rayrender::TileRenderer& renderer, const Vec3& camOrigin, int width, int height, const rayscene::SphereBvh& spheres, Light light, int echantillonsNumber, std::uint64_t seed) const {
     if (width <= 0 || height <= 0) {
         return;
     }
 
-    const Real aspect = Real(width) / Real(height);
-    const Real focal_length = 4.0;
+    const rayscene::Camera camera(camOrigin, width, height);
 
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
+    renderer.render(width, height, [&](const rayrender::Tile& tile) {
+        rayrender::ForEachPixel(tile, [&](int x, int y) {
             Vec3 accumulatorColor(0, 0, 0);
+            const std::uint64_t pixelIndex = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
 
             for (int echantillon = 0; echantillon < echantillonsNumber; ++echantillon) {
-                Real sampleX = Real(x) + randomReal(0, 1);
-                Real sampleY = Real(y) + randomReal(0, 1);
+                SampleRng rng(seed, pixelIndex, static_cast<std::uint64_t>(echantillon));
+                Real sampleX = Real(x) + rng.nextReal();
+                Real sampleY = Real(y) + rng.nextReal();
 
-                const Real screenX = ((Real(2.0) * sampleX / width) - Real(1.0)) * aspect;
-                const Real screenY = (Real(2.0) * sampleY / height) - Real(1.0);
-
-                Vec3 rayDirection(screenX, -screenY, focal_length);
-                rayDirection = rayDirection.normalized();
-                const Ray ray(camOrigin, rayDirection);
+                const Ray ray = camera.generateRay(sampleX, sampleY);
 
                 if (ray.direction().y < 0) {
                     // Calculer distance t jusqu'au plan
                     float t = (posY - ray.origin().y) / ray.direction().y;
 
-                    Vec3 floorPoint = ray.at(t);
-
-                    float floorX = floorPoint.x;
-                    float floorZ = floorPoint.z;
-
-                    int gridX = (int)floor(floorX / tileSize);
-                    int gridZ = (int)floor(floorZ / tileSize);
-
                     HitInfo hit;
                     hit.t = t;
-                    hit.point = floorPoint;
-
-                    DiffuseShader shader;
-                    float shadowFactor = shader.ShadowFactorPlane(hit, light, spheres);
-
-                    bool isWhite = (gridX + gridZ) % 2 == 0;
-                    Color baseColor = isWhite ? colors[0] : colors[1];
-
-                    Vec3 shadedColor(
-                        baseColor.R() * shadowFactor,
-                        baseColor.G() * shadowFactor,
-                        baseColor.B() * shadowFactor
-                    );
-
-                    Vec3 planeNormal(0, 1, 0);
-                    Vec3 reflectDir = ray.direction().reflect(planeNormal);
-                    Ray reflectRay(hit.point, reflectDir);
-                    Real reflect_closest_t = numeric_limits<Real>::infinity();
-
-                    for (const auto& sphere : spheres) {
-                        const auto sphereHit = sphere.intersect(reflectRay);
-                        if (sphereHit && sphereHit->t < reflect_closest_t) {
-                            reflect_closest_t = sphereHit->t;
-                            Vec3 sphereShadedColor = sphere.getShadedColor(*sphereHit, reflectRay, light, spheres, camOrigin, *this);
-                            shadedColor = (shadedColor + (sphereShadedColor * sphere.reflectFactor())) * shadowFactor;
-                        }
-                    }
-
-                    accumulatorColor = accumulatorColor + shadedColor;
+                    hit.point = ray.at(t);
+
+                    accumulatorColor = accumulatorColor + shade(ray, hit, light, spheres, camOrigin);
                 }
             }
 
             Vec3 finalColor(accumulatorColor.x / echantillonsNumber, accumulatorColor.y / echantillonsNumber, accumulatorColor.z / echantillonsNumber);
 
             image.SetPixel(x, y, Color(finalColor.x, finalColor.y, finalColor.z));
-        }
-    }
+        });
+    });
 }
@@ -7,6 +7,9 @@
 #include "../raymath/Intersection.hpp"
 #include "../rayimage/Image.hpp"
 #include "../rayscene/Sphere.hpp"
+#include "../rayscene/SphereBvh.hpp"
+#include "../rayrender/TileRenderer.hpp"
+#include <cstdint>
 #include <optional>
 
 using namespace math;
@@ -21,9 +24,12 @@ class Plane {
     public:
         Plane(array<Color, 2> colors, float posY = 0.0f, float tileSize = 1.0f);
 
-        void DrawPlane(Image& image, const Vec3& camOrigin, int width, int height, const std::vector<rayscene::Sphere>& spheres, Light light, int echantillonsNumber = 1);
+        void DrawPlane(Image& image, rayrender::TileRenderer& renderer, const Vec3& camOrigin, int width, int height, const rayscene::SphereBvh& spheres, Light light, int echantillonsNumber = 1, std::uint64_t seed = 0) const;
 
         optional<HitInfo> intersect(const Ray& ray) const noexcept;
 
         Vec3 getColorAt(const Vec3& point) const noexcept;
+
+        // Couleur d'un échantillon qui touche le plan : damier, ombre portée et reflet des sphères.
+        Vec3 shade(const Ray& ray, const HitInfo& hit, Light light, const rayscene::SphereBvh& spheres, const Vec3& camOrigin) const noexcept;
 };
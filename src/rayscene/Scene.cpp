@@ -0,0 +1,81 @@
+#include "Scene.hpp"
+
+#include <stdexcept>
+
+namespace rayscene {
+
+using math::Vec3;
+
+namespace {
+
+Plane makePlane(const SceneConfig& config) {
+    return config.plane
+        ? Plane({config.plane->primaryColor, config.plane->secondaryColor},
+                config.plane->posY,
+                config.plane->tileSize)
+        : Plane({Color(1, 1, 1), Color(0, 0, 0)}, 0.0f, 1.0f);
+}
+
+std::vector<Sphere> makeSpheres(const SceneConfig& config) {
+    std::vector<Sphere> spheres;
+    spheres.reserve(config.spheres.size());
+    for (const auto& sphereCfg : config.spheres) {
+        spheres.emplace_back(sphereCfg.center,
+                             sphereCfg.radius,
+                             nullptr,
+                             sphereCfg.color,
+                             sphereCfg.reflectFactor,
+                             sphereCfg.specularPower);
+    }
+    return spheres;
+}
+
+} // namespace
+
+Scene::Scene(const SceneConfig& config)
+    : m_spheres(makeSpheres(config))
+    , m_plane(makePlane(config))
+    , m_light(config.light ? Light(config.light->position) : Light(Vec3(-5.0, 1.5, 5.0)))
+    , m_cameraOrigin(config.camera.origin)
+{}
+
+void Scene::applyFrame(const SceneConfig& frame) {
+    if (frame.spheres.size() != m_spheres.spheres().size()) {
+        throw std::invalid_argument("Scene::applyFrame: sphere count differs from the scene");
+    }
+    std::vector<Vec3> centers;
+    centers.reserve(frame.spheres.size());
+    for (const auto& sphereCfg : frame.spheres) {
+        centers.push_back(sphereCfg.center);
+    }
+    m_spheres.setCenters(centers);
+    m_light = frame.light ? Light(frame.light->position) : Light(Vec3(-5.0, 1.5, 5.0));
+    m_cameraOrigin = frame.camera.origin;
+}
+
+const std::vector<Sphere>& Scene::spheres() const noexcept {
+    return m_spheres.spheres();
+}
+
+const SphereBvh& Scene::sphereBvh() const noexcept {
+    return m_spheres;
+}
+
+// Le plan ne porte pas d'ombre : seules les sphères comptent.
+bool Scene::occluded(const math::Ray& ray, math::Real tMax) const noexcept {
+    return m_spheres.occluded(ray, tMax);
+}
+
+const Plane& Scene::plane() const noexcept {
+    return m_plane;
+}
+
+Light Scene::light() const noexcept {
+    return m_light;
+}
+
+const Vec3& Scene::cameraOrigin() const noexcept {
+    return m_cameraOrigin;
+}
+
+} // namespace rayscene
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../raymath/Vec3.hpp"
+#include "Light.hpp"
+#include "Plane.hpp"
+#include "SceneLoader.hpp"
+#include "Sphere.hpp"
+#include "SphereBvh.hpp"
+
+#include <vector>
+
+namespace rayscene {
+
+// Objets de la scène construits à partir d'une SceneConfig, partagés en lecture par les workers.
+class Scene {
+public:
+    explicit Scene(const SceneConfig& config);
+
+    // Image d'une animation (FrameConfig) : ne met à jour que ce que les pistes animent
+    // (caméra, lumière, centres des sphères) ; le reste de la scène est conservé.
+    void applyFrame(const SceneConfig& frame);
+
+    const std::vector<Sphere>& spheres() const noexcept;
+    // BVH des sphères, construit au chargement et reconstruit par applyFrame().
+    const SphereBvh& sphereBvh() const noexcept;
+    // Vrai si un objet de la scène coupe le rayon avant tMax (rayons d'ombre).
+    bool occluded(const math::Ray& ray, math::Real tMax) const noexcept;
+    const Plane& plane() const noexcept;
+    Light light() const noexcept;
+    const math::Vec3& cameraOrigin() const noexcept;
+
+private:
+    SphereBvh m_spheres;
+    Plane m_plane;
+    Light m_light;
+    math::Vec3 m_cameraOrigin;
+};
+
+} // namespace rayscene
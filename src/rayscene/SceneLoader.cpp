@@ -2,6 +2,7 @@
 
 #include "../nlohmann/json.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <string>
@@ -30,16 +31,75 @@ Color readColor(const nlohmann::json& node, const std::string& context) {
     );
 }
 
-} // namespace
+// "scene.png" -> "scene_####.png"
+std::string defaultFramePattern(const std::string& outputPath) {
+    const std::size_t slash = outputPath.find_last_of('/');
+    const std::size_t dot = outputPath.find_last_of('.');
+    const std::size_t insertAt = (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? outputPath.size() : dot;
+    return outputPath.substr(0, insertAt) + "_####" + outputPath.substr(insertAt);
+}
 
-SceneConfig LoadSceneFromJson(const std::string& filepath) {
-    std::ifstream input(filepath);
-    if (!input) {
-        throw std::runtime_error("Unable to open scene file: " + filepath);
+void sortTrack(Track& track) {
+    std::stable_sort(track.begin(), track.end(), [](const Keyframe& a, const Keyframe& b) {
+        return a.frame < b.frame;
+    });
+}
+
+AnimationConfig readAnimation(const nlohmann::json& node, const SceneConfig& config) {
+    AnimationConfig animation;
+
+    const auto& frames = node.at("frames");
+    if (!frames.is_array() || frames.size() != 2) {
+        throw std::runtime_error("animation.frames must be [first, last]");
+    }
+    animation.firstFrame = frames[0].get<int>();
+    animation.lastFrame = frames[1].get<int>();
+    if (animation.firstFrame < 0 || animation.lastFrame < animation.firstFrame) {
+        throw std::runtime_error("animation.frames must satisfy 0 <= first <= last");
+    }
+
+    animation.outputPattern = node.value("output", defaultFramePattern(config.outputPath));
+    if (animation.outputPattern.find('#') == std::string::npos) {
+        throw std::runtime_error("animation.output must contain '#' for the frame number");
     }
 
-    nlohmann::json root = nlohmann::json::parse(input);
+    animation.sphereCenters.resize(config.spheres.size());
+    const auto& keyframes = node.at("keyframes");
+    if (!keyframes.is_array() || keyframes.size() == 0) {
+        throw std::runtime_error("animation.keyframes must be a non-empty array");
+    }
+    for (const auto& key : keyframes) {
+        const double frame = key.at("frame").get<double>();
+        if (key.contains("camera")) {
+            animation.camera.push_back(Keyframe{frame, readVec3(key.at("camera"), "animation.keyframes.camera")});
+        }
+        if (key.contains("light")) {
+            animation.light.push_back(Keyframe{frame, readVec3(key.at("light"), "animation.keyframes.light")});
+        }
+        if (key.contains("spheres")) {
+            const auto& spheres = key.at("spheres");
+            if (!spheres.is_array()) {
+                throw std::runtime_error("animation.keyframes.spheres must be an array");
+            }
+            for (const auto& sphere : spheres) {
+                const int index = sphere.at("index").get<int>();
+                if (index < 0 || static_cast<std::size_t>(index) >= config.spheres.size()) {
+                    throw std::runtime_error("animation.keyframes.spheres: index out of range");
+                }
+                animation.sphereCenters[index].push_back(Keyframe{frame, readVec3(sphere.at("center"), "animation.keyframes.spheres.center")});
+            }
+        }
+    }
+
+    sortTrack(animation.camera);
+    sortTrack(animation.light);
+    for (Track& track : animation.sphereCenters) {
+        sortTrack(track);
+    }
+    return animation;
+}
 
+SceneConfig readScene(const nlohmann::json& root) {
     SceneConfig config{};
 
     const auto& image = root.at("image");
@@ -54,6 +114,52 @@ SceneConfig LoadSceneFromJson(const std::string& filepath) {
     config.outputPath = root.value("output", std::string("scene.png"));
     config.timerLabel = root.value("timer_label", std::string("Scene render"));
     config.echantillonsNumber = root.value("echantillonsNumber", 1);
+    config.seed = static_cast<std::uint64_t>(root.value("seed", 0LL));
+
+    if (root.contains("render")) {
+        const auto& render = root.at("render");
+        if (render.contains("threads")) {
+            const int threads = render.at("threads").get<int>();
+            if (threads <= 0) {
+                throw std::runtime_error("render.threads must be positive");
+            }
+            config.render.threads = static_cast<unsigned>(threads);
+        }
+        if (render.contains("affinity")) {
+            try {
+                config.render.affinity = rayrender::ParseAffinityMode(render.at("affinity").get<std::string>());
+            } catch (const std::invalid_argument& error) {
+                throw std::runtime_error(std::string("render.affinity: ") + error.what());
+            }
+        }
+        if (render.contains("order")) {
+            try {
+                config.render.order = rayrender::ParseTraversalOrder(render.at("order").get<std::string>());
+            } catch (const std::invalid_argument& error) {
+                throw std::runtime_error(std::string("render.order: ") + error.what());
+            }
+        }
+        if (render.contains("executor")) {
+            try {
+                config.render.executor = rayrender::ParseExecutorKind(render.at("executor").get<std::string>());
+            } catch (const std::invalid_argument& error) {
+                throw std::runtime_error(std::string("render.executor: ") + error.what());
+            }
+        }
+        if (render.contains("time_limit")) {
+            const double limit = render.at("time_limit").get<double>();
+            if (limit <= 0) {
+                throw std::runtime_error("render.time_limit must be positive");
+            }
+            config.render.timeLimitSeconds = limit;
+        }
+        if (render.contains("sample_parallel")) {
+            config.render.sampleParallel = render.at("sample_parallel").get<bool>();
+        }
+        if (render.contains("tile_costs")) {
+            config.render.tileCosts = render.at("tile_costs").get<bool>();
+        }
+    }
 
     const auto& camera = root.at("camera");
     config.camera.origin = readVec3(camera.at("origin"), "camera.origin");
@@ -118,7 +224,26 @@ SceneConfig LoadSceneFromJson(const std::string& filepath) {
         }
     }
 
+    // Après les sphères : les clés y font référence par index.
+    if (root.contains("animation")) {
+        config.animation = readAnimation(root.at("animation"), config);
+    }
+
     return config;
 }
 
+} // namespace
+
+SceneConfig LoadSceneFromJson(const std::string& filepath) {
+    std::ifstream input(filepath);
+    if (!input) {
+        throw std::runtime_error("Unable to open scene file: " + filepath);
+    }
+    return readScene(nlohmann::json::parse(input));
+}
+
+SceneConfig ParseSceneJson(const std::string& text) {
+    return readScene(nlohmann::json::parse(text));
+}
+
 } // namespace rayscene
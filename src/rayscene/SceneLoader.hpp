@@ -2,7 +2,11 @@
 
 #include "../raymath/Color.hpp"
 #include "../raymath/Vec3.hpp"
+#include "../rayrender/Executor.hpp"
+#include "../rayrender/Topology.hpp"
+#include "../rayrender/TraversalOrder.hpp"
 
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <vector>
@@ -36,6 +40,37 @@ struct SphereConfig {
     int specularPower;
 };
 
+// Bloc "render" optionnel : réglages d'exécution, remplacés par les options de la ligne de commande.
+struct RenderConfig {
+    std::optional<unsigned> threads;
+    std::optional<rayrender::AffinityMode> affinity;
+    std::optional<rayrender::TraversalOrder> order;
+    std::optional<rayrender::ExecutorKind> executor;
+    std::optional<double> timeLimitSeconds;
+    std::optional<bool> sampleParallel;
+    std::optional<bool> tileCosts;
+};
+
+// Clé d'une piste d'animation : valeur à l'image frame.
+struct Keyframe {
+    double frame;
+    math::Vec3 value;
+};
+
+// Clés triées par image ; interpolation linéaire entre deux clés, valeur constante au-delà.
+using Track = std::vector<Keyframe>;
+
+// Bloc "animation" optionnel : images firstFrame..lastFrame, chacune écrite dans outputPattern
+// (les '#' sont remplacés par le numéro d'image complété de zéros).
+struct AnimationConfig {
+    int firstFrame = 0;
+    int lastFrame = 0;
+    std::string outputPattern;
+    Track camera;                      // Origine de la caméra
+    Track light;                       // Position de la lumière
+    std::vector<Track> sphereCenters;  // Une piste par sphère, vide si la sphère ne bouge pas
+};
+
 struct SceneConfig {
     int width;
     int height;
@@ -47,8 +82,13 @@ struct SceneConfig {
     std::optional<LightConfig> light;
     std::vector<SphereConfig> spheres;
     int echantillonsNumber;
+    std::uint64_t seed;
+    RenderConfig render;
+    std::optional<AnimationConfig> animation;
 };
 
 SceneConfig LoadSceneFromJson(const std::string& filepath);
+// Même format, depuis le texte JSON (scènes envoyées au démon).
+SceneConfig ParseSceneJson(const std::string& text);
 
 } // namespace rayscene
@@ -2,9 +2,14 @@
 #include "../rayimage/Image.hpp"
 #include "../raymath/Color.hpp"
 #include "../raymath/Constants.hpp"
+#include "../raymath/Random.hpp"
 #include "Light.hpp"
 #include "Plane.hpp"
+#include "SphereBvh.hpp"
+#include "SphereTileBins.hpp"
+#include "Camera.hpp"
 #include "../rayshader/DiffuseShader.hpp"
+#include "../rayrender/RenderStats.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -16,6 +21,7 @@ using math::HitInfo;
 using math::Ray;
 using math::Vec3;
 using math::Real;
+using math::SampleRng;
 using ::Color;
 
 Sphere::Sphere(const Vec3& center, math::Real radius, std::shared_ptr<Material> mat, const math::Real reflectFactor, int specularPower) noexcept
@@ -42,6 +48,10 @@ const Vec3& Sphere::center() const noexcept {
     return m_center;
 }
 
+void Sphere::setCenter(const Vec3& center) noexcept {
+    m_center = center;
+}
+
 math::Real Sphere::radius() const noexcept {
     return m_radius;
 }
@@ -58,13 +68,14 @@ int Sphere::specularPower() const noexcept {
     return m_specularPower;
 }
 
-Vec3 Sphere::getShadedColor(const HitInfo& hit, const Ray& incidentRay, Light light, const std::vector<Sphere>& spheres, const Vec3& camera, const Plane& plane) const noexcept {
+Vec3 Sphere::getShadedColor(const HitInfo& hit, const Ray& incidentRay, Light light, const SphereBvh& spheres, const Vec3& camera, const Plane& plane) const noexcept {
     DiffuseShader shader;
     float intensity = shader.Shade(hit, light, spheres, camera, m_specularPower);
     Vec3 baseColor = m_color * intensity;
 
     Vec3 reflectDir = incidentRay.direction().reflect(hit.normal);
     Ray reflectRay(hit.point, reflectDir);
+    rayrender::stats::CountRay(rayrender::RayKind::Reflection);
 
     const auto planeHit = plane.intersect(reflectRay);
     if (planeHit) {
@@ -76,16 +87,34 @@ Vec3 Sphere::getShadedColor(const HitInfo& hit, const Ray& incidentRay, Light li
 }
 
 std::optional<HitInfo> Sphere::intersect(const Ray& ray) const noexcept {
+    const auto t = hitDistance(ray);
+    if (!t) return std::nullopt;
+    return surfaceInteraction(ray, *t);
+}
+
+std::optional<Real> Sphere::hitDistance(const Ray& ray) const noexcept {
+    rayrender::stats::CountSphereTest();
     const Vec3 oc = ray.origin() - m_center;
     const math::Real a = ray.direction().dot(ray.direction());
     const math::Real b = 2 * oc.dot(ray.direction());
     const math::Real c = oc.dot(oc) - m_radius2;
 
-    const auto roots = math::solveQuadratic(a, b, c);
-    const auto tOpt = math::firstValidHit(roots, math::RAY_MIN_T);
-    if (!tOpt) return std::nullopt;
+    return math::firstValidHit(math::solveQuadratic(a, b, c), math::RAY_MIN_T);
+}
+
+SphereOriginTerms Sphere::originTerms(const Vec3& origin) const noexcept {
+    const Vec3 oc = origin - m_center;
+    return SphereOriginTerms{oc, oc.dot(oc) - m_radius2};
+}
 
-    const math::Real t = *tOpt;
+// Mêmes opérations que hitDistance(ray) : le t obtenu est identique au bit près.
+std::optional<Real> Sphere::hitDistance(const SphereOriginTerms& terms, const Vec3& direction, Real directionLength2) noexcept {
+    rayrender::stats::CountSphereTest();
+    const math::Real b = 2 * terms.oc.dot(direction);
+    return math::firstValidHit(math::solveQuadratic(directionLength2, b, terms.c), math::RAY_MIN_T);
+}
+
+HitInfo Sphere::surfaceInteraction(const Ray& ray, Real t) const noexcept {
     HitInfo info;
     info.t = t;
     info.point = ray.at(t);
@@ -100,89 +129,74 @@ std::optional<HitInfo> Sphere::intersect(const Ray& ray) const noexcept {
     return info;
 }
 
+bool Sphere::occludes(const Ray& ray, Real tMax) const noexcept {
+    const auto t = hitDistance(ray);
+    return t && *t < tMax;
+}
+
+Vec3 Sphere::shade(const HitInfo& hit, const Ray& ray, Light light, const SphereBvh& spheres, const Vec3& camera, const Plane& plane) const noexcept {
+    DiffuseShader shader;
+    float intensity = shader.Shade(hit, light, spheres, camera, m_specularPower);
+    Vec3 baseColor = m_color * intensity;
+
+    Vec3 reflectDir = ray.direction().reflect(hit.normal);
+    Ray reflectRay(hit.point, reflectDir);
+    rayrender::stats::CountRay(rayrender::RayKind::Reflection);
+
+    // Seule la couleur de la sphère reflétée compte : pas besoin de son HitInfo.
+    if (const auto reflectHit = spheres.closestIntersection(reflectRay)) {
+        const Sphere& reflected = spheres.spheres()[reflectHit->sphere];
+        baseColor = baseColor + (reflected.color() * reflected.reflectFactor() * intensity);
+    }
+
+    const auto planeHit = plane.intersect(reflectRay);
+    if (planeHit) {
+        Vec3 planeColor = plane.getColorAt(planeHit->point);
+        baseColor = baseColor + (planeColor * intensity * m_reflectFactor);
+    }
+
+    return baseColor;
+}
+
 void Sphere::DrawSphere(Image& image,
+                        rayrender::TileRenderer& renderer,
                         const Vec3& camOrigin,
                         int width,
                         int height,
-                        const std::vector<Sphere>& spheres,
+                        const SphereBvh& spheres,
                         Light light,
                         const Plane& plane,
-                        int echantillonsNumber) {
+                        int echantillonsNumber,
+                        std::uint64_t seed) {
     if (width <= 0 || height <= 0) {
         return;
     }
 
-    const Real aspect = Real(width) / Real(height);
-    const Real focal_length = 4.0;
+    const Camera camera(camOrigin, width, height);
+    const CameraSphereTable cameraSpheres(spheres, camOrigin);
+    const SphereTileBins bins(spheres, cameraSpheres, camera, renderer, width, height);
 
-    auto clampColor = [](Real value) -> float {
-        if (value < 0) {
-            return 0.0f;
+    // Seconde passe du rendu en deux passes (après DrawPlane) : ses pixels sont définitifs.
+    renderer.beginFinalPass();
+    renderer.render(width, height, [&](const rayrender::Tile& tile) {
+        // Aucune sphère ne se projette sur la tuile : le plan déjà dessiné reste tel quel.
+        if (bins.empty(tile)) {
+            return;
         }
-        if (value > 1) {
-            return 1.0f;
-        }
-        return static_cast<float>(value);
-    };
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
+        rayrender::ForEachPixel(tile, [&](int x, int y) {
             Vec3 accumulatorColor(0, 0, 0);
+            const std::uint64_t pixelIndex = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
 
             for (int echantillon = 0; echantillon < echantillonsNumber; ++echantillon) {
-                Real sampleX = Real(x) + randomReal(0, 1);
-                Real sampleY = Real(y) + randomReal(0, 1);
-
-                const Real screenX = ((Real(2.0) * sampleX / width) - Real(1.0)) * aspect;
-                const Real screenY = (Real(2.0) * sampleY / height) - Real(1.0);
-
-                Vec3 rayDirection(screenX, -screenY, focal_length);
-                rayDirection = rayDirection.normalized();
-                const Ray ray(camOrigin, rayDirection);
-    
-                Real closest_t = std::numeric_limits<Real>::infinity();
-                Vec3 color(0.0, 0.0, 0.0);
-                bool hitSphere = false;
-                std::optional<HitInfo> closestHit;
-                int specularPowerToUse = 0;
-                Real reflectFactorToUse = 0;
-    
-                for (const auto& sphere : spheres) {
-                    const auto hit = sphere.intersect(ray);
-                    if (hit && hit->t < closest_t) {
-                        closest_t = hit->t;
-                        color = sphere.color();
-                        closestHit = hit;
-                        hitSphere = true;
-                        specularPowerToUse = sphere.specularPower();
-                        reflectFactorToUse = sphere.reflectFactor();
-                    }
-                }
-    
-                if (hitSphere && closestHit) {
-                    DiffuseShader shader;
-                    float intensity = shader.Shade(*closestHit, light, spheres, camOrigin, specularPowerToUse);
-                    Vec3 baseColor = color * intensity;
-
-                    Vec3 reflectDir = ray.direction().reflect(closestHit->normal);
-                    Ray reflectRay(closestHit->point, reflectDir);
-                    Real reflect_closest_t = std::numeric_limits<Real>::infinity();
-
-                    for (const auto& sphere : spheres) {
-                        const auto hit = sphere.intersect(reflectRay);
-                        if (hit && hit->t < reflect_closest_t) {
-                            reflect_closest_t = hit->t;
-                            baseColor = baseColor + (sphere.color() * sphere.reflectFactor() * intensity);
-                        }
-                    }
-
-                    const auto planeHit = plane.intersect(reflectRay);
-                    if (planeHit) {
-                        Vec3 planeColor = plane.getColorAt(planeHit->point);
-                        baseColor = baseColor + (planeColor * intensity * reflectFactorToUse);
-                    }
-
-                    accumulatorColor = accumulatorColor + baseColor;
+                SampleRng rng(seed, pixelIndex, static_cast<std::uint64_t>(echantillon));
+                Real sampleX = Real(x) + rng.nextReal();
+                Real sampleY = Real(y) + rng.nextReal();
+
+                const Ray ray = camera.generateRay(sampleX, sampleY);
+
+                if (const auto closest = bins.closestIntersection(tile, ray)) {
+                    const SphereHit hit = spheres.surfaceInteraction(ray, *closest);
+                    accumulatorColor = accumulatorColor + hit.sphere->shade(hit.hit, ray, light, spheres, camOrigin, plane);
                 }
             }
 
@@ -191,15 +205,25 @@ void Sphere::DrawSphere(Image& image,
                 Vec3 finalColor(accumulatorColor.x / echantillonsNumber, accumulatorColor.y / echantillonsNumber, accumulatorColor.z / echantillonsNumber);
 
                 const Color pixelColor(
-                    clampColor(finalColor.x),
-                    clampColor(finalColor.y),
-                    clampColor(finalColor.z)
+                    ClampColor(finalColor.x),
+                    ClampColor(finalColor.y),
+                    ClampColor(finalColor.z)
                 );
 
                 image.SetPixel(static_cast<unsigned>(x), static_cast<unsigned>(y), pixelColor);
             }
-        }
+        });
+    });
+}
+
+float ClampColor(Real value) noexcept {
+    if (value < 0) {
+        return 0.0f;
+    }
+    if (value > 1) {
+        return 1.0f;
     }
+    return static_cast<float>(value);
 }
 
 } // namespace rayscene
@@ -4,7 +4,9 @@
 #include "../raymath/Ray.hpp"
 #include "../raymath/Intersection.hpp"
 #include "Light.hpp"
+#include "../rayrender/TileRenderer.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -15,6 +17,14 @@ class Plane;
 namespace rayscene {
 
 struct Material; // placeholder for future extensions
+class SphereBvh;
+
+// Termes de l'intersection qui ne dépendent que de l'origine du rayon, pas de sa direction :
+// oc = origine - centre et c = oc·oc - r². Communs à tous les rayons primaires d'une image.
+struct SphereOriginTerms {
+    math::Vec3 oc;
+    math::Real c;
+};
 
 class Sphere {
 public:
@@ -22,24 +32,44 @@ public:
     Sphere(const math::Vec3& center, math::Real radius, std::shared_ptr<Material> mat, const math::Vec3& color, const math::Real reflectFactor, int specularPower = 0) noexcept;
 
     const math::Vec3& center() const noexcept;
+    // Déplace la sphère (animation) ; rayon et matériau sont conservés.
+    void setCenter(const math::Vec3& center) noexcept;
     math::Real radius() const noexcept;
     const math::Vec3& color() const noexcept;
 
     std::optional<math::HitInfo> intersect(const math::Ray& ray) const noexcept;
+    // Moitié rapide de intersect() : seulement la distance du premier impact (t > RAY_MIN_T).
+    std::optional<math::Real> hitDistance(const math::Ray& ray) const noexcept;
+    // Moitié différée : point, normale orientée et uv de l'impact à la distance t.
+    // À n'appeler que pour l'impact retenu (acos et atan2 pour les uv).
+    math::HitInfo surfaceInteraction(const math::Ray& ray, math::Real t) const noexcept;
+
+    SphereOriginTerms originTerms(const math::Vec3& origin) const noexcept;
+    // hitDistance() d'un rayon dont l'origine a donné `terms` : un produit scalaire et le
+    // discriminant. directionLength2 = direction·direction, commun à toutes les sphères.
+    static std::optional<math::Real> hitDistance(const SphereOriginTerms& terms, const math::Vec3& direction, math::Real directionLength2) noexcept;
+    // Rayon d'ombre : vrai si la sphère coupe le rayon entre RAY_MIN_T et tMax (exclu).
+    // Ni point, ni normale, ni uv.
+    bool occludes(const math::Ray& ray, math::Real tMax) const noexcept;
     static void DrawSphere(Image& image,
+                           rayrender::TileRenderer& renderer,
                            const math::Vec3& camOrigin,
                            int width,
                            int height,
-                           const std::vector<Sphere>& spheres,
+                           const SphereBvh& spheres,
                            Light light,
                            const Plane& plane,
-                           int echantillonsNumber = 1);
+                           int echantillonsNumber = 1,
+                           std::uint64_t seed = 0);
 
     math::Real reflectFactor() const noexcept;
 
     int specularPower() const noexcept;
 
-    math::Vec3 getShadedColor(const math::HitInfo& hit, const math::Ray& incidentRay, Light light, const std::vector<Sphere>& spheres, const math::Vec3& camera, const Plane& plane) const noexcept;
+    // Couleur d'un rayon primaire qui touche la sphère : éclairage, reflets des sphères et du plan.
+    math::Vec3 shade(const math::HitInfo& hit, const math::Ray& ray, Light light, const SphereBvh& spheres, const math::Vec3& camera, const Plane& plane) const noexcept;
+
+    math::Vec3 getShadedColor(const math::HitInfo& hit, const math::Ray& incidentRay, Light light, const SphereBvh& spheres, const math::Vec3& camera, const Plane& plane) const noexcept;
 
 private:
     math::Vec3 m_center;
@@ -51,4 +81,7 @@ private:
     int m_specularPower;
 };
 
+// Ramène une composante dans [0, 1] avant écriture dans l'image.
+float ClampColor(math::Real value) noexcept;
+
 } // namespace rayscene
@@ -0,0 +1,323 @@
+#include "SphereBvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace rayscene {
+
+using math::Ray;
+using math::Real;
+using math::Vec3;
+
+namespace {
+
+constexpr int BinCount = 16;
+constexpr std::uint32_t MaxLeafSize = 4;
+constexpr int MaxDepth = 64;                  // Borne aussi la pile de parcours
+constexpr Real TraversalCost = 0.5;           // Test d'une boîte, relatif au test d'une sphère
+constexpr Real IntersectionCost = 1.0;
+
+struct Bounds {
+    Vec3 min{std::numeric_limits<Real>::infinity()};
+    Vec3 max{-std::numeric_limits<Real>::infinity()};
+
+    void grow(const Vec3& point) noexcept {
+        min = math::min(min, point);
+        max = math::max(max, point);
+    }
+    void grow(const Bounds& other) noexcept {
+        min = math::min(min, other.min);
+        max = math::max(max, other.max);
+    }
+    Real area() const noexcept {
+        if (min.x > max.x) return 0;
+        const Vec3 d = max - min;
+        return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+};
+
+// Boîte légèrement élargie : les arrondis du test de boîte ne doivent jamais écarter
+// une sphère que Sphere::intersect toucherait.
+Bounds sphereBounds(const Sphere& sphere) noexcept {
+    const Real r = sphere.radius() * (1 + 1e-9) + 1e-9;
+    Bounds bounds;
+    bounds.min = sphere.center() - Vec3(r);
+    bounds.max = sphere.center() + Vec3(r);
+    return bounds;
+}
+
+} // namespace
+
+SphereBvh::SphereBvh(std::vector<Sphere> spheres)
+    : m_spheres(std::move(spheres)) {
+    build();
+}
+
+void SphereBvh::setCenters(const std::vector<Vec3>& centers) {
+    if (centers.size() != m_spheres.size()) {
+        throw std::invalid_argument("SphereBvh::setCenters: sphere count differs");
+    }
+    for (std::size_t i = 0; i < m_spheres.size(); ++i) {
+        m_spheres[i].setCenter(centers[i]);
+    }
+    build();
+}
+
+void SphereBvh::build() {
+    m_nodes.clear();
+    m_order.resize(m_spheres.size());
+    for (std::size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = static_cast<std::uint32_t>(i);
+    }
+    if (m_spheres.empty()) {
+        return;
+    }
+    m_nodes.reserve(2 * m_spheres.size());
+    buildNode(0, static_cast<std::uint32_t>(m_order.size()), 0);
+}
+
+std::uint32_t SphereBvh::buildNode(std::uint32_t first, std::uint32_t last, int depth) {
+    Bounds bounds;
+    Bounds centroids;
+    for (std::uint32_t i = first; i < last; ++i) {
+        const Sphere& sphere = m_spheres[m_order[i]];
+        bounds.grow(sphereBounds(sphere));
+        centroids.grow(sphere.center());
+    }
+
+    const auto index = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+    for (int axis = 0; axis < 3; ++axis) {
+        m_nodes[index].boundsMin[axis] = bounds.min[axis];
+        m_nodes[index].boundsMax[axis] = bounds.max[axis];
+    }
+
+    const std::uint32_t count = last - first;
+    const auto makeLeaf = [&] {
+        m_nodes[index].offset = first;
+        m_nodes[index].count = count;
+        return index;
+    };
+    if (count == 1 || depth >= MaxDepth) {
+        return makeLeaf();
+    }
+
+    // SAH par intervalles : coût = traversée + somme (aire de l'enfant / aire du parent) x nombre de sphères.
+    const Real area = bounds.area();
+    const Real invArea = area > 0 ? 1 / area : 0;
+    Real bestCost = std::numeric_limits<Real>::infinity();
+    int bestAxis = -1;
+    int bestSplit = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        const Real extent = centroids.max[axis] - centroids.min[axis];
+        if (!(extent > 0)) {
+            continue;
+        }
+        const Real scale = BinCount / extent;
+        std::array<Bounds, BinCount> bins{};
+        std::array<std::uint32_t, BinCount> binCounts{};
+        for (std::uint32_t i = first; i < last; ++i) {
+            const Sphere& sphere = m_spheres[m_order[i]];
+            const int bin = std::min(BinCount - 1, static_cast<int>((sphere.center()[axis] - centroids.min[axis]) * scale));
+            ++binCounts[bin];
+            bins[bin].grow(sphereBounds(sphere));
+        }
+
+        std::array<Real, BinCount> rightArea{};
+        std::array<std::uint32_t, BinCount> rightCount{};
+        Bounds right;
+        std::uint32_t rightTotal = 0;
+        for (int bin = BinCount - 1; bin > 0; --bin) {
+            right.grow(bins[bin]);
+            rightTotal += binCounts[bin];
+            rightArea[bin] = right.area();
+            rightCount[bin] = rightTotal;
+        }
+
+        Bounds left;
+        std::uint32_t leftTotal = 0;
+        for (int split = 0; split < BinCount - 1; ++split) {
+            left.grow(bins[split]);
+            leftTotal += binCounts[split];
+            if (leftTotal == 0 || rightCount[split + 1] == 0) {
+                continue;
+            }
+            const Real cost = TraversalCost
+                + (left.area() * leftTotal + rightArea[split + 1] * rightCount[split + 1]) * invArea * IntersectionCost;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+
+    std::uint32_t middle = first;
+    int splitAxis = bestAxis;
+    if (bestAxis < 0) {
+        // Centres confondus : aucun découpage utile, on coupe en deux si la feuille serait trop grosse.
+        if (count <= MaxLeafSize) {
+            return makeLeaf();
+        }
+        middle = first + count / 2;
+        splitAxis = 0;
+    } else {
+        if (count <= MaxLeafSize && bestCost >= count * IntersectionCost) {
+            return makeLeaf();
+        }
+        const Real scale = BinCount / (centroids.max[bestAxis] - centroids.min[bestAxis]);
+        const auto split = std::partition(m_order.begin() + first, m_order.begin() + last, [&](std::uint32_t sphere) {
+            const int bin = std::min(BinCount - 1, static_cast<int>((m_spheres[sphere].center()[bestAxis] - centroids.min[bestAxis]) * scale));
+            return bin <= bestSplit;
+        });
+        middle = static_cast<std::uint32_t>(split - m_order.begin());
+    }
+
+    buildNode(first, middle, depth + 1);  // Fils gauche : index + 1
+    const std::uint32_t right = buildNode(middle, last, depth + 1);
+    m_nodes[index].offset = right;
+    m_nodes[index].axis = static_cast<std::uint32_t>(splitAxis);
+    return index;
+}
+
+bool SphereBvh::entersBox(const Node& node, const Vec3& origin, const Real* invDirection, Real tMax) noexcept {
+    Real tNear = 0;
+    Real tFar = tMax;
+    for (int axis = 0; axis < 3; ++axis) {
+        Real t0 = (node.boundsMin[axis] - origin[axis]) * invDirection[axis];
+        Real t1 = (node.boundsMax[axis] - origin[axis]) * invDirection[axis];
+        if (invDirection[axis] < 0) std::swap(t0, t1);
+        if (t0 > tNear) tNear = t0;
+        if (t1 < tFar) tFar = t1;
+    }
+    return tNear <= tFar;
+}
+
+CameraSphereTable::CameraSphereTable(const SphereBvh& bvh, const Vec3& origin)
+    : m_origin(origin)
+    , m_order(&bvh.m_order) {
+    m_terms.reserve(bvh.m_order.size());
+    for (std::uint32_t sphere : bvh.m_order) {
+        m_terms.push_back(bvh.m_spheres[sphere].originTerms(origin));
+    }
+}
+
+template <class HitDistance>
+std::optional<SphereIntersection> SphereBvh::traverseClosest(const Ray& ray, HitDistance hitDistance) const noexcept {
+    if (m_nodes.empty()) {
+        return std::nullopt;
+    }
+
+    const Vec3& origin = ray.origin();
+    const Vec3& direction = ray.direction();
+    const Real invDirection[3] = {1 / direction.x, 1 / direction.y, 1 / direction.z};
+
+    Real closest = std::numeric_limits<Real>::infinity();
+    bool found = false;
+    std::uint32_t bestIndex = 0;
+
+    std::uint32_t stack[MaxDepth];
+    int stackSize = 0;
+    std::uint32_t current = 0;
+    for (;;) {
+        const Node& node = m_nodes[current];
+        if (entersBox(node, origin, invDirection, closest)) {
+            if (node.count == 0) {
+                std::uint32_t near = current + 1;
+                std::uint32_t far = node.offset;
+                if (invDirection[node.axis] < 0) std::swap(near, far);
+                stack[stackSize++] = far;
+                current = near;
+                continue;
+            }
+            for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+                const std::uint32_t sphere = m_order[i];
+                const auto t = hitDistance(i);
+                if (t && (*t < closest || (*t == closest && sphere < bestIndex))) {
+                    closest = *t;
+                    found = true;
+                    bestIndex = sphere;
+                }
+            }
+        }
+        if (stackSize == 0) {
+            break;
+        }
+        current = stack[--stackSize];
+    }
+
+    if (!found) {
+        return std::nullopt;
+    }
+    return SphereIntersection{closest, bestIndex};
+}
+
+std::optional<SphereIntersection> SphereBvh::closestIntersection(const Ray& ray) const noexcept {
+    return traverseClosest(ray, [&](std::uint32_t i) { return m_spheres[m_order[i]].hitDistance(ray); });
+}
+
+std::optional<SphereIntersection> SphereBvh::closestIntersection(const Ray& ray, const CameraSphereTable& camera) const noexcept {
+    const Vec3& direction = ray.direction();
+    const Real directionLength2 = direction.dot(direction);
+    return traverseClosest(ray, [&](std::uint32_t i) { return camera.hitDistance(i, direction, directionLength2); });
+}
+
+std::optional<SphereHit> SphereBvh::closestHit(const Ray& ray) const noexcept {
+    const auto intersection = closestIntersection(ray);
+    if (!intersection) {
+        return std::nullopt;
+    }
+    return surfaceInteraction(ray, *intersection);
+}
+
+std::optional<SphereHit> SphereBvh::closestHit(const Ray& ray, const CameraSphereTable& camera) const noexcept {
+    const auto intersection = closestIntersection(ray, camera);
+    if (!intersection) {
+        return std::nullopt;
+    }
+    return surfaceInteraction(ray, *intersection);
+}
+
+SphereHit SphereBvh::surfaceInteraction(const Ray& ray, const SphereIntersection& intersection) const noexcept {
+    const Sphere& sphere = m_spheres[intersection.sphere];
+    return SphereHit{sphere.surfaceInteraction(ray, intersection.t), &sphere};
+}
+
+// Pas d'ordre de visite : n'importe quel obstacle suffit.
+bool SphereBvh::occluded(const Ray& ray, Real tMax) const noexcept {
+    if (m_nodes.empty()) {
+        return false;
+    }
+
+    const Vec3& origin = ray.origin();
+    const Vec3& direction = ray.direction();
+    const Real invDirection[3] = {1 / direction.x, 1 / direction.y, 1 / direction.z};
+
+    std::uint32_t stack[MaxDepth];
+    int stackSize = 0;
+    std::uint32_t current = 0;
+    for (;;) {
+        const Node& node = m_nodes[current];
+        if (entersBox(node, origin, invDirection, tMax)) {
+            if (node.count == 0) {
+                stack[stackSize++] = node.offset;
+                current = current + 1;
+                continue;
+            }
+            for (std::uint32_t i = node.offset; i < node.offset + node.count; ++i) {
+                if (m_spheres[m_order[i]].occludes(ray, tMax)) {
+                    return true;
+                }
+            }
+        }
+        if (stackSize == 0) {
+            return false;
+        }
+        current = stack[--stackSize];
+    }
+}
+
+} // namespace rayscene
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../raymath/Ray.hpp"
+#include "../raymath/Intersection.hpp"
+#include "Sphere.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace rayscene {
+
+// Impact le plus proche, distance seule : t et indice de la sphère dans spheres().
+struct SphereIntersection {
+    math::Real t = 0;
+    std::uint32_t sphere = 0;
+};
+
+// Impact le plus proche avec ses attributs de surface.
+struct SphereHit {
+    math::HitInfo hit;
+    const Sphere* sphere = nullptr;
+};
+
+class SphereBvh;
+
+// Table d'une image : originTerms() de chaque sphère pour l'origine commune des rayons
+// primaires (la caméra), rangée dans l'ordre des feuilles du BVH pour être lue d'un trait.
+// À reconstruire quand la caméra ou les sphères bougent.
+class CameraSphereTable {
+public:
+    CameraSphereTable(const SphereBvh& bvh, const math::Vec3& origin);
+
+    const math::Vec3& origin() const noexcept { return m_origin; }
+
+    // Entrées par position dans l'ordre des feuilles.
+    std::size_t size() const noexcept { return m_terms.size(); }
+    std::uint32_t sphereAt(std::size_t position) const noexcept { return (*m_order)[position]; }
+    std::optional<math::Real> hitDistance(std::size_t position, const math::Vec3& direction, math::Real directionLength2) const noexcept {
+        return Sphere::hitDistance(m_terms[position], direction, directionLength2);
+    }
+
+private:
+    friend class SphereBvh;
+
+    math::Vec3 m_origin;
+    const std::vector<std::uint32_t>* m_order;
+    std::vector<SphereOriginTerms> m_terms;
+};
+
+// Hiérarchie de boîtes englobantes sur les sphères de la scène, construite par la
+// surface area heuristic (SAH, découpage par intervalles de centres).
+// Les nœuds sont rangés à plat en profondeur d'abord : le fils gauche suit son parent,
+// seul l'indice du fils droit est stocké, et les sphères d'une feuille sont contiguës.
+// Possède les sphères : elles ne peuvent changer que par setCenters(), qui reconstruit l'arbre.
+class SphereBvh {
+public:
+    explicit SphereBvh(std::vector<Sphere> spheres);
+
+    const std::vector<Sphere>& spheres() const noexcept { return m_spheres; }
+
+    // Déplace les sphères (une image d'animation) puis reconstruit la hiérarchie.
+    void setCenters(const std::vector<math::Vec3>& centers);
+
+    // Sphère la plus proche touchée par le rayon (t > RAY_MIN_T). À distance égale, la sphère
+    // de plus petit indice l'emporte, comme dans une boucle sur toutes les sphères.
+    // Les candidats ne sont testés qu'en distance ; les attributs de surface ne sont calculés
+    // que pour l'impact retenu, par closestHit() ou surfaceInteraction().
+    std::optional<SphereIntersection> closestIntersection(const math::Ray& ray) const noexcept;
+    std::optional<SphereHit> closestHit(const math::Ray& ray) const noexcept;
+    // Rayons primaires : ray.origin() doit être camera.origin(). Même résultat que sans table.
+    std::optional<SphereIntersection> closestIntersection(const math::Ray& ray, const CameraSphereTable& camera) const noexcept;
+    std::optional<SphereHit> closestHit(const math::Ray& ray, const CameraSphereTable& camera) const noexcept;
+    SphereHit surfaceInteraction(const math::Ray& ray, const SphereIntersection& intersection) const noexcept;
+
+    // Rayon d'ombre : vrai dès qu'une sphère coupe le rayon avant tMax. S'arrête au premier
+    // obstacle, sans calculer d'attributs de surface.
+    bool occluded(const math::Ray& ray, math::Real tMax) const noexcept;
+
+    std::size_t nodeCount() const noexcept { return m_nodes.size(); }
+
+private:
+    friend class CameraSphereTable;
+
+    struct alignas(64) Node {
+        math::Real boundsMin[3];
+        math::Real boundsMax[3];
+        std::uint32_t offset = 0;  // Feuille : première entrée de m_order ; sinon : fils droit
+        std::uint32_t count = 0;   // Nombre de sphères d'une feuille, 0 pour un nœud interne
+        std::uint32_t axis = 0;    // Axe de découpage, pour visiter d'abord le fils le plus proche
+    };
+
+    // Méthode des slabs sur [0, tMax] ; un NaN (rayon parallèle sur un bord) laisse la borne inchangée.
+    static bool entersBox(const Node& node, const math::Vec3& origin, const math::Real* invDirection, math::Real tMax) noexcept;
+
+    // Parcours le plus proche d'abord ; hitDistance(i) teste l'entrée i de m_order.
+    template <class HitDistance>
+    std::optional<SphereIntersection> traverseClosest(const math::Ray& ray, HitDistance hitDistance) const noexcept;
+
+    void build();
+    std::uint32_t buildNode(std::uint32_t first, std::uint32_t last, int depth);
+
+    std::vector<Sphere> m_spheres;
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_order;  // Indices des sphères, dans l'ordre des feuilles
+};
+
+} // namespace rayscene
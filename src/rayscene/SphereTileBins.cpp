@@ -0,0 +1,142 @@
+#include "SphereTileBins.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rayscene {
+
+using math::Ray;
+using math::Real;
+using math::Vec3;
+
+namespace {
+
+// Au-delà, le parcours du BVH coûte moins que la boucle sur les candidates.
+constexpr std::size_t LinearCandidateLimit = 16;
+
+// Pentes u/z (u = x ou y) des rayons issus de l'origine qui peuvent toucher le disque de centre
+// (u, z) et de rayon radius, projection de la sphère sur le plan (u, z). Infinies si le cône des
+// tangentes dépasse le plan de la caméra ; false si aucun rayon vers l'avant (z > 0) ne le touche.
+bool slopeRange(Real u, Real z, Real radius, Real& lo, Real& hi) {
+    constexpr Real inf = std::numeric_limits<Real>::infinity();
+    constexpr Real quarter = math::PI / 2;
+    const Real distance = std::sqrt(u * u + z * z);
+    if (distance <= radius) {
+        lo = -inf;  // La caméra est dans le disque
+        hi = inf;
+        return true;
+    }
+    const Real center = std::atan2(u, z);
+    const Real half = std::asin(radius / distance);
+    const Real low = center - half;
+    const Real high = center + half;
+    if (high <= -quarter || low >= quarter) {
+        return false;
+    }
+    lo = low <= -quarter ? -inf : std::tan(low);
+    hi = high >= quarter ? inf : std::tan(high);
+    return true;
+}
+
+// Pixels [first, last] dont un échantillon (de x inclus à x + 1 exclu) peut tomber dans [lo, hi],
+// avec un pixel de marge ; false si l'intervalle sort de l'image.
+bool pixelRange(Real lo, Real hi, int size, int& first, int& last) {
+    if (!(hi >= 0) || !(lo < size)) {
+        return false;
+    }
+    first = lo <= 1 ? 0 : static_cast<int>(std::floor(lo)) - 1;
+    last = hi >= size - 2 ? size - 1 : static_cast<int>(std::floor(hi)) + 1;
+    return true;
+}
+
+} // namespace
+
+SphereTileBins::SphereTileBins(const SphereBvh& spheres, const CameraSphereTable& cameraSpheres, const Camera& camera,
+                               const rayrender::TileRenderer& renderer, int width, int height)
+    : m_spheres(spheres)
+    , m_cameraSpheres(cameraSpheres) {
+    const std::vector<rayrender::Tile> tiles = rayrender::MakeTiles(width, height, renderer.settings().tileSize, renderer.settings().order);
+    m_candidates.resize(tiles.size());
+    if (tiles.empty()) {
+        return;
+    }
+
+    // Les tuiles suivent une grille (une ligne par tuile en Scanline, des carrés sinon) : case -> tuile.
+    int cellWidth = 1;
+    int cellHeight = 1;
+    for (const rayrender::Tile& tile : tiles) {
+        cellWidth = std::max(cellWidth, tile.x1 - tile.x0);
+        cellHeight = std::max(cellHeight, tile.y1 - tile.y0);
+    }
+    const int columns = (width + cellWidth - 1) / cellWidth;
+    const int rows = (height + cellHeight - 1) / cellHeight;
+    std::vector<int> cellTile(static_cast<std::size_t>(columns) * rows, -1);
+    for (const rayrender::Tile& tile : tiles) {
+        cellTile[static_cast<std::size_t>(tile.y0 / cellHeight) * columns + tile.x0 / cellWidth] = tile.index;
+    }
+
+    // Écran de Camera::generateRay : direction (screenX, -screenY, focalLength).
+    const Real focal = camera.focalLength();
+    const Real aspect = camera.aspect();
+    for (std::size_t position = 0; position < cameraSpheres.size(); ++position) {
+        const Sphere& sphere = spheres.spheres()[cameraSpheres.sphereAt(position)];
+        const Vec3 p = sphere.center() - cameraSpheres.origin();
+        const Real radius = sphere.radius() * (1 + 1e-6);
+
+        Real xLo, xHi, yLo, yHi;
+        if (!slopeRange(p.x, p.z, radius, xLo, xHi) || !slopeRange(p.y, p.z, radius, yLo, yHi)) {
+            continue;
+        }
+        int x0, x1, y0, y1;
+        if (!pixelRange((xLo * focal / aspect + 1) * width / 2, (xHi * focal / aspect + 1) * width / 2, width, x0, x1)
+            || !pixelRange((1 - yHi * focal) * height / 2, (1 - yLo * focal) * height / 2, height, y0, y1)) {
+            continue;
+        }
+
+        for (int row = y0 / cellHeight; row <= y1 / cellHeight; ++row) {
+            for (int column = x0 / cellWidth; column <= x1 / cellWidth; ++column) {
+                const int tile = cellTile[static_cast<std::size_t>(row) * columns + column];
+                if (tile >= 0) {
+                    m_candidates[tile].push_back(static_cast<std::uint32_t>(position));
+                }
+            }
+        }
+    }
+}
+
+bool SphereTileBins::empty(const rayrender::Tile& tile) const noexcept {
+    return m_candidates[tile.index].empty();
+}
+
+std::optional<SphereIntersection> SphereTileBins::closestIntersection(const rayrender::Tile& tile, const Ray& ray) const noexcept {
+    const std::vector<std::uint32_t>& candidates = m_candidates[tile.index];
+    if (candidates.size() > LinearCandidateLimit) {
+        return m_spheres.closestIntersection(ray, m_cameraSpheres);
+    }
+
+    const Vec3& direction = ray.direction();
+    const Real directionLength2 = direction.dot(direction);
+    Real closest = std::numeric_limits<Real>::infinity();
+    bool found = false;
+    std::uint32_t bestIndex = 0;
+    for (std::uint32_t position : candidates) {
+        const auto t = m_cameraSpheres.hitDistance(position, direction, directionLength2);
+        if (!t) {
+            continue;
+        }
+        const std::uint32_t sphere = m_cameraSpheres.sphereAt(position);
+        if (*t < closest || (*t == closest && sphere < bestIndex)) {
+            closest = *t;
+            found = true;
+            bestIndex = sphere;
+        }
+    }
+
+    if (!found) {
+        return std::nullopt;
+    }
+    return SphereIntersection{closest, bestIndex};
+}
+
+} // namespace rayscene
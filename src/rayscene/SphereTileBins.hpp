@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../raymath/Ray.hpp"
+#include "../rayrender/TileRenderer.hpp"
+#include "Camera.hpp"
+#include "SphereBvh.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace rayscene {
+
+// Sphères candidates de chaque tuile pour les rayons primaires d'une image.
+// Chaque sphère est projetée avec le modèle de Camera (focalLength, aspect) : l'intervalle de
+// pentes des rayons qui peuvent la toucher, séparément en x et en y (tangentes au disque projeté),
+// donne un rectangle de pixels conservateur (une marge d'un pixel), ajouté aux tuiles qu'il couvre.
+// Les tuiles sont celles de MakeTiles pour les réglages du renderer : à reconstruire si la taille,
+// les tuiles, la caméra ou les sphères changent.
+class SphereTileBins {
+public:
+    SphereTileBins(const SphereBvh& spheres, const CameraSphereTable& cameraSpheres, const Camera& camera,
+                   const rayrender::TileRenderer& renderer, int width, int height);
+
+    // Aucune sphère ne peut toucher la tuile : ses rayons primaires ne voient que le plan ou le fond.
+    bool empty(const rayrender::Tile& tile) const noexcept;
+
+    // Même résultat que SphereBvh::closestIntersection(ray, cameraSpheres) pour un rayon primaire
+    // de la tuile : boucle sur les candidates si elles sont peu nombreuses, parcours du BVH sinon.
+    std::optional<SphereIntersection> closestIntersection(const rayrender::Tile& tile, const math::Ray& ray) const noexcept;
+
+private:
+    const SphereBvh& m_spheres;
+    const CameraSphereTable& m_cameraSpheres;
+    std::vector<std::vector<std::uint32_t>> m_candidates;  // Par Tile::index : positions dans la table
+};
+
+} // namespace rayscene
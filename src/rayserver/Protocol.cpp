@@ -0,0 +1,259 @@
+#include "Protocol.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace rayserver {
+
+namespace {
+
+constexpr std::size_t MaxHeaderBytes = 64 * 1024;
+constexpr std::size_t MaxPayloadBytes = std::size_t(1) << 30;  // 1 Go : au-delà, le client se trompe
+
+bool needsEscape(unsigned char c) {
+    return c <= ' ' || c == '%' || c == '=' || c == 0x7f;
+}
+
+std::string escape(const std::string& value) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(value.size());
+    for (unsigned char c : value) {
+        if (needsEscape(c)) {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+std::string unescape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] != '%') {
+            out += value[i];
+            continue;
+        }
+        const int high = i + 2 < value.size() ? hexDigit(value[i + 1]) : -1;
+        const int low = high >= 0 ? hexDigit(value[i + 2]) : -1;
+        if (low < 0) {
+            throw std::runtime_error("Protocol: bad escape in header");
+        }
+        out += static_cast<char>(high * 16 + low);
+        i += 2;
+    }
+    return out;
+}
+
+void writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        // MSG_NOSIGNAL : un client parti ne tue pas le démon par SIGPIPE.
+        const ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Protocol: write failed: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+// Retourne le nombre d'octets lus : moins que size seulement si la connexion est fermée.
+std::size_t readAll(int fd, char* data, std::size_t size) {
+    std::size_t total = 0;
+    while (total < size) {
+        const ssize_t got = ::recv(fd, data + total, size - total, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Protocol: read failed: ") + std::strerror(errno));
+        }
+        if (got == 0) break;
+        total += static_cast<std::size_t>(got);
+    }
+    return total;
+}
+
+sockaddr_un socketAddress(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is empty or too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+} // namespace
+
+std::string Message::field(const std::string& key, const std::string& fallback) const {
+    const auto it = fields.find(key);
+    return it != fields.end() ? it->second : fallback;
+}
+
+bool Message::has(const std::string& key) const {
+    return fields.count(key) > 0;
+}
+
+std::string DefaultSocketPath() {
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+        return std::string(runtime) + "/hetic-raytracerd.sock";
+    }
+    return "/tmp/hetic-raytracerd-" + std::to_string(::getuid()) + ".sock";
+}
+
+bool ReadMessage(int fd, Message& message) {
+    std::string header;
+    for (;;) {
+        char c;
+        if (readAll(fd, &c, 1) == 0) {
+            if (header.empty()) return false;
+            throw std::runtime_error("Protocol: connection closed inside a header");
+        }
+        if (c == '\n') break;
+        header += c;
+        if (header.size() > MaxHeaderBytes) {
+            throw std::runtime_error("Protocol: header too long");
+        }
+    }
+
+    message = Message();
+    std::size_t start = 0;
+    while (start <= header.size()) {
+        std::size_t end = header.find(' ', start);
+        if (end == std::string::npos) end = header.size();
+        const std::string word = header.substr(start, end - start);
+        start = end + 1;
+        if (word.empty()) continue;
+
+        if (message.command.empty()) {
+            message.command = word;
+            continue;
+        }
+        const std::size_t equals = word.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("Protocol: expected key=value, got " + word);
+        }
+        message.fields[word.substr(0, equals)] = unescape(word.substr(equals + 1));
+    }
+    if (message.command.empty()) {
+        throw std::runtime_error("Protocol: empty header");
+    }
+
+    if (message.has("length")) {
+        char* end = nullptr;
+        const std::string text = message.field("length");
+        const unsigned long long length = std::strtoull(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || length > MaxPayloadBytes) {
+            throw std::runtime_error("Protocol: bad length " + text);
+        }
+        message.payload.resize(static_cast<std::size_t>(length));
+        if (readAll(fd, message.payload.data(), message.payload.size()) != message.payload.size()) {
+            throw std::runtime_error("Protocol: connection closed inside a payload");
+        }
+        message.fields.erase("length");
+    }
+    return true;
+}
+
+void WriteMessage(int fd, const Message& message) {
+    std::string header = message.command;
+    for (const auto& [key, value] : message.fields) {
+        if (key.empty() || key == "length" || key.find_first_of(" =%\n") != std::string::npos) {
+            throw std::runtime_error("Protocol: invalid field name " + key);
+        }
+        header += ' ' + key + '=' + escape(value);
+    }
+    if (!message.payload.empty()) {
+        header += " length=" + std::to_string(message.payload.size());
+    }
+    header += '\n';
+
+    writeAll(fd, header.data(), header.size());
+    writeAll(fd, message.payload.data(), message.payload.size());
+}
+
+int ListenSocket(const std::string& path) {
+    const sockaddr_un address = socketAddress(path);
+
+    struct stat info{};
+    if (::lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error("Not a socket, refusing to replace: " + path);
+        }
+        bool alive = false;
+        try {
+            ::close(ConnectSocket(path));
+            alive = true;
+        } catch (const std::runtime_error&) {
+        }
+        if (alive) {
+            throw std::runtime_error("A daemon is already listening on " + path);
+        }
+        ::unlink(path.c_str());  // Socket d'un démon arrêté
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    // Socket en 0600 : seul l'utilisateur du démon peut lui demander de lire ou d'écrire des fichiers.
+    const mode_t previous = ::umask(0077);
+    const int bound = ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    ::umask(previous);
+    if (bound < 0 || ::listen(fd, 64) < 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Unable to listen on " + path + ": " + reason);
+    }
+    return fd;
+}
+
+int ConnectSocket(const std::string& path) {
+    const sockaddr_un address = socketAddress(path);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        const std::string reason = std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error("Unable to connect to " + path + ": " + reason);
+    }
+    return fd;
+}
+
+Message Call(const std::string& socketPath, const Message& request) {
+    const int fd = ConnectSocket(socketPath);
+    try {
+        WriteMessage(fd, request);
+        Message reply;
+        if (!ReadMessage(fd, reply)) {
+            throw std::runtime_error("Daemon closed the connection without replying");
+        }
+        ::close(fd);
+        return reply;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+}
+
+} // namespace rayserver
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace rayserver {
+
+// Message du démon, dans les deux sens : une ligne d'en-tête "COMMANDE clé=valeur ..." puis,
+// si l'en-tête contient length=N, N octets de contenu (JSON, chemin, PNG ou message d'erreur).
+// Dans l'en-tête, espaces, '%', '=' et caractères de contrôle des valeurs sont encodés en %XX.
+//
+// Requêtes : PING, SHUTDOWN, RENDER source=json|path reply=png|file [seed=N] [output=PATH] [time_limit=S]
+// Réponses : OK [champs...] ou ERROR (message dans le contenu).
+struct Message {
+    std::string command;
+    std::map<std::string, std::string> fields;
+    std::string payload;
+
+    // Valeur du champ key, ou fallback s'il est absent.
+    std::string field(const std::string& key, const std::string& fallback = "") const;
+    bool has(const std::string& key) const;
+};
+
+// $XDG_RUNTIME_DIR/hetic-raytracerd.sock, sinon /tmp/hetic-raytracerd-<uid>.sock.
+std::string DefaultSocketPath();
+
+// Lit un message complet. Retourne false si la connexion est fermée avant un nouveau message ;
+// lève std::runtime_error sur un message tronqué ou mal formé.
+bool ReadMessage(int fd, Message& message);
+
+// Écrit un message complet (length est ajouté d'après le contenu). Lève std::runtime_error.
+void WriteMessage(int fd, const Message& message);
+
+// Socket Unix en écoute, accessible au seul utilisateur. Un fichier de socket laissé par un démon
+// arrêté est remplacé ; lève std::runtime_error si un démon répond déjà sur ce chemin.
+int ListenSocket(const std::string& path);
+
+// Connexion au démon ; lève std::runtime_error si personne n'écoute.
+int ConnectSocket(const std::string& path);
+
+// Client : une requête, une réponse, sur une connexion ouverte pour l'occasion.
+Message Call(const std::string& socketPath, const Message& request);
+
+} // namespace rayserver
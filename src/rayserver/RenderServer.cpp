@@ -0,0 +1,511 @@
+#include "RenderServer.hpp"
+
+#include "../rayapp/Animation.hpp"
+#include "../rayscene/Scene.hpp"
+#include "../rayscene/SceneLoader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace rayserver {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Message errorReply(const std::string& text) {
+    Message reply;
+    reply.command = "ERROR";
+    reply.payload = text;
+    return reply;
+}
+
+double parseSeconds(const std::string& text) {
+    char* end = nullptr;
+    const double seconds = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || !(seconds > 0)) {
+        throw std::invalid_argument("Invalid time_limit: " + text);
+    }
+    return seconds;
+}
+
+std::uint64_t parseSeed(const std::string& text) {
+    char* end = nullptr;
+    const unsigned long long seed = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0') {
+        throw std::invalid_argument("Invalid seed: " + text);
+    }
+    return seed;
+}
+
+std::string formatMs(double seconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << seconds * 1000.0;
+    return text.str();
+}
+
+} // namespace
+
+JobPriority ParseJobPriority(const std::string& text) {
+    if (text == "low") return JobPriority::Low;
+    if (text == "normal") return JobPriority::Normal;
+    if (text == "high") return JobPriority::High;
+    throw std::invalid_argument("priority must be low, normal or high, got " + text);
+}
+
+const char* JobPriorityName(JobPriority priority) noexcept {
+    switch (priority) {
+        case JobPriority::Low: return "low";
+        case JobPriority::High: return "high";
+        case JobPriority::Normal: break;
+    }
+    return "normal";
+}
+
+RenderServer::RenderServer(rayrender::TileRenderer& renderer, ServerOptions options, std::ostream& log)
+    : m_options(std::move(options))
+    , m_log(log)
+    // Même réglages (threads, affinité) : le job préempté rend la main, ses CPU passent à la voie de préemption.
+    , m_preemptRenderer(std::make_unique<rayrender::TileRenderer>(renderer.settings())) {
+    if (m_options.socketPath.empty()) {
+        m_options.socketPath = DefaultSocketPath();
+    }
+    m_main.name = "main";
+    m_main.renderer = &renderer;
+    m_preempt.name = "preempt";
+    m_preempt.renderer = m_preemptRenderer.get();
+
+    if (m_options.metrics) {
+        Metrics& metrics = *m_options.metrics;
+        m_renderMetrics.emplace(metrics);
+        m_main.pipeline.setMetrics(&*m_renderMetrics);
+        m_preempt.pipeline.setMetrics(&*m_renderMetrics);
+
+        std::array<MetricValue*, JobPriorityCount> queued{};
+        for (std::size_t p = 0; p < JobPriorityCount; ++p) {
+            const std::string labels = std::string("priority=\"") + JobPriorityName(static_cast<JobPriority>(p)) + "\"";
+            queued[p] = &metrics.gauge("hetic_queue_depth", "Jobs waiting to be rendered.", labels);
+            m_waitHistograms[p] = &metrics.histogram("hetic_queue_wait_seconds", "Time from arrival to start of rendering.", labels);
+        }
+        MetricValue& running = metrics.gauge("hetic_jobs_running", "Jobs being rendered (2 while one is preempted).");
+        MetricValue& completed = metrics.counter("hetic_jobs_total", "Render requests served.", "status=\"ok\"");
+        MetricValue& failed = metrics.counter("hetic_jobs_total", "Render requests served.", "status=\"error\"");
+        MetricValue& preemptions = metrics.counter("hetic_preemptions_total", "Jobs paused for a higher priority one.");
+        metrics.addCollector([this, queued, &running, &completed, &failed, &preemptions] {
+            const ServerStats snapshot = stats();
+            for (std::size_t p = 0; p < JobPriorityCount; ++p) {
+                queued[p]->set(static_cast<double>(snapshot.queued[p]));
+            }
+            running.set(static_cast<double>(snapshot.running));
+            completed.set(static_cast<double>(snapshot.completed));
+            failed.set(static_cast<double>(snapshot.failed));
+            preemptions.set(static_cast<double>(snapshot.preemptions));
+        });
+    }
+}
+
+RenderServer::~RenderServer() {
+    stop();
+    { std::lock_guard<std::mutex> lock(m_mutex); }
+    m_changed.notify_all();
+    for (Lane* lane : {&m_main, &m_preempt}) {
+        if (lane->thread.joinable()) {
+            lane->thread.join();
+        }
+    }
+}
+
+void RenderServer::stop() noexcept {
+    // Seulement des écritures atomiques : appelé depuis le gestionnaire de SIGINT/SIGTERM.
+    m_stopping.store(true, std::memory_order_relaxed);
+    m_main.cancellation.cancel();
+    m_preempt.cancellation.cancel();
+}
+
+ServerStats RenderServer::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ServerStats snapshot = m_stats;
+    for (const Job* job : m_jobs) {
+        ++snapshot.queued[static_cast<std::size_t>(job->priority)];
+    }
+    snapshot.running = (m_main.current ? 1 : 0) + (m_preempt.current ? 1 : 0);
+    return snapshot;
+}
+
+void RenderServer::run() {
+    const int listenFd = ListenSocket(m_options.socketPath);
+    // Jetons posés pour toute la vie du démon (stop()) : seul un job avec time_limit leur donne
+    // une échéance, donc seul lui passe en rendu progressif.
+    for (Lane* lane : {&m_main, &m_preempt}) {
+        lane->renderer->setCancellationToken(&lane->cancellation);
+    }
+    m_main.renderer->setTileGate(&m_gate);
+    m_main.thread = std::thread([this] { laneLoop(m_main); });
+    m_preempt.thread = std::thread([this] { laneLoop(m_preempt); });
+    {
+        std::lock_guard<std::mutex> lock(m_logMutex);
+        m_log << "Listening on " << m_options.socketPath << std::endl;
+    }
+
+    // poll() avec délai : stop() n'a pas à réveiller accept() depuis un gestionnaire de signal.
+    while (!m_stopping.load(std::memory_order_relaxed)) {
+        pollfd waiting{listenFd, POLLIN, 0};
+        if (::poll(&waiting, 1, 200) <= 0) {
+            continue;
+        }
+        const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_connections.insert(fd);
+        }
+        std::thread([this, fd] { serveConnection(fd); }).detach();
+    }
+
+    ::close(listenFd);
+    ::unlink(m_options.socketPath.c_str());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (int fd : m_connections) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    m_changed.notify_all();
+    m_connectionsDone.wait(lock, [this] { return m_connections.empty(); });
+    lock.unlock();
+
+    for (Lane* lane : {&m_main, &m_preempt}) {
+        lane->thread.join();
+        lane->renderer->setCancellationToken(nullptr);
+    }
+    m_main.renderer->setTileGate(nullptr);
+}
+
+void RenderServer::serveConnection(int fd) {
+    try {
+        Message request;
+        while (ReadMessage(fd, request)) {
+            if (request.command == "PING") {
+                Message reply;
+                reply.command = "OK";
+                reply.fields["threads"] = std::to_string(m_main.renderer->threadCount());
+                WriteMessage(fd, reply);
+            } else if (request.command == "STATS") {
+                const ServerStats snapshot = stats();
+                Message reply;
+                reply.command = "OK";
+                std::size_t queued = 0;
+                for (std::size_t p = 0; p < JobPriorityCount; ++p) {
+                    const std::string name = JobPriorityName(static_cast<JobPriority>(p));
+                    const WaitStats& wait = snapshot.wait[p];
+                    queued += snapshot.queued[p];
+                    reply.fields["queued_" + name] = std::to_string(snapshot.queued[p]);
+                    reply.fields["jobs_" + name] = std::to_string(wait.jobs);
+                    reply.fields["wait_ms_avg_" + name] = formatMs(wait.jobs ? wait.totalSeconds / wait.jobs : 0.0);
+                    reply.fields["wait_ms_max_" + name] = formatMs(wait.maxSeconds);
+                }
+                reply.fields["queued"] = std::to_string(queued);
+                reply.fields["running"] = std::to_string(snapshot.running);
+                reply.fields["completed"] = std::to_string(snapshot.completed);
+                reply.fields["failed"] = std::to_string(snapshot.failed);
+                reply.fields["preemptions"] = std::to_string(snapshot.preemptions);
+                WriteMessage(fd, reply);
+            } else if (request.command == "METRICS") {
+                if (!m_options.metrics) {
+                    throw std::runtime_error("Metrics are disabled");
+                }
+                std::ostringstream text;
+                m_options.metrics->write(text);
+                Message reply;
+                reply.command = "OK";
+                reply.payload = text.str();
+                WriteMessage(fd, reply);
+            } else if (request.command == "SHUTDOWN") {
+                Message reply;
+                reply.command = "OK";
+                WriteMessage(fd, reply);
+                stop();
+            } else if (request.command == "RENDER") {
+                Job job;
+                job.priority = ParseJobPriority(request.field("priority", "normal"));
+                job.request = std::move(request);
+                std::future<Message> reply = job.reply.get_future();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stopping.load(std::memory_order_relaxed)) {
+                        job.reply.set_value(errorReply("Daemon is stopping"));
+                    } else {
+                        // Après les jobs de même priorité : FIFO à priorité égale.
+                        const auto position = std::find_if(m_jobs.begin(), m_jobs.end(), [&job](const Job* queued) {
+                            return queued->priority < job.priority;
+                        });
+                        job.enqueued = Clock::now();
+                        m_jobs.insert(position, &job);
+                    }
+                }
+                m_changed.notify_all();
+                WriteMessage(fd, reply.get());
+            } else {
+                WriteMessage(fd, errorReply("Unknown command: " + request.command));
+            }
+        }
+    } catch (const std::exception& error) {
+        try {
+            WriteMessage(fd, errorReply(error.what()));
+        } catch (const std::exception&) {
+        }
+    }
+
+    ::close(fd);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connections.erase(fd);
+    if (m_connections.empty()) {
+        m_connectionsDone.notify_all();
+    }
+}
+
+bool RenderServer::canStart(const Lane& lane) const {
+    if (m_jobs.empty() || lane.current) {
+        return false;
+    }
+    if (&lane == &m_main) {
+        return !m_preempt.current;
+    }
+    // La voie de préemption ne sert que les jobs plus prioritaires que celui de la voie principale.
+    return m_main.current && m_jobs.front()->priority > m_main.current->priority;
+}
+
+void RenderServer::laneLoop(Lane& lane) {
+    const bool preempting = &lane == &m_preempt;
+    for (;;) {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_changed.wait_for(lock, std::chrono::milliseconds(200), [this, &lane] {
+                return canStart(lane) || m_stopping.load(std::memory_order_relaxed);
+            });
+            if (m_stopping.load(std::memory_order_relaxed)) {
+                for (Job* pending : m_jobs) {
+                    pending->reply.set_value(errorReply("Daemon is stopping"));
+                }
+                m_jobs.clear();
+                return;
+            }
+            if (!canStart(lane)) {
+                continue;
+            }
+            job = m_jobs.front();
+            m_jobs.pop_front();
+            lane.current = job;
+
+            const Clock::time_point now = Clock::now();
+            const double waited = std::chrono::duration<double>(now - job->enqueued).count();
+            WaitStats& wait = m_stats.wait[static_cast<std::size_t>(job->priority)];
+            ++wait.jobs;
+            wait.totalSeconds += waited;
+            wait.maxSeconds = std::max(wait.maxSeconds, waited);
+            if (Histogram* histogram = m_waitHistograms[static_cast<std::size_t>(job->priority)]) {
+                histogram->observe(waited);
+            }
+            job->waitSeconds = waited;
+
+            if (preempting && !m_gate.isClosed()) {
+                m_gate.close();
+                m_pauseStart = now;
+                ++m_stats.preemptions;
+                std::lock_guard<std::mutex> logLock(m_logMutex);
+                m_log << "Pausing a " << JobPriorityName(m_main.current->priority)
+                      << " priority job for a " << JobPriorityName(job->priority) << " priority one" << std::endl;
+            }
+        }
+
+        Message reply;
+        try {
+            reply = render(lane, *job);
+        } catch (const std::exception& error) {
+            reply = errorReply(error.what());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            lane.current = nullptr;
+            ++(reply.command == "OK" ? m_stats.completed : m_stats.failed);
+            // Le job suspendu reprend dès qu'aucun job plus prioritaire n'attend.
+            if (preempting && (m_stopping.load(std::memory_order_relaxed) || !canStart(lane))) {
+                const Clock::duration paused = Clock::now() - m_pauseStart;
+                if (m_main.current) {
+                    m_main.current->pausedSeconds += std::chrono::duration<double>(paused).count();
+                }
+                m_main.cancellation.extendDeadline(paused);  // La limite de temps ne compte pas la pause
+                m_gate.open();
+            }
+        }
+        m_changed.notify_all();
+        job->reply.set_value(std::move(reply));
+    }
+}
+
+Message RenderServer::render(Lane& lane, Job& job) {
+    const Message& request = job.request;
+    rayrender::TileRenderer& renderer = *lane.renderer;
+    const Clock::time_point start = Clock::now();
+    const std::string source = request.field("source", "json");
+    const std::string replyKind = request.field("reply", "png");
+    if (source != "json" && source != "path") {
+        throw std::invalid_argument("source must be json or path");
+    }
+    if (replyKind != "png" && replyKind != "file") {
+        throw std::invalid_argument("reply must be png or file");
+    }
+
+    rayscene::SceneConfig config = source == "path"
+        ? rayscene::LoadSceneFromJson(request.payload)
+        : rayscene::ParseSceneJson(request.payload);
+    if (request.has("seed")) {
+        config.seed = parseSeed(request.field("seed"));
+    }
+    if (request.has("output")) {
+        if (config.animation) {
+            config.animation->outputPattern = request.field("output");
+        } else {
+            config.outputPath = request.field("output");
+        }
+    }
+    if (config.animation && replyKind != "file") {
+        throw std::invalid_argument("animated scenes need reply=file");
+    }
+
+    rayapp::FrameOptions frameOptions = m_options.frame;
+    frameOptions.sampleParallel = frameOptions.sampleParallel || config.render.sampleParallel.value_or(false);
+    renderer.setTraversalOrder(config.render.order.value_or(rayrender::TraversalOrder::Tiled));
+    renderer.setTileCostHint({});
+    renderer.resetTileCosts();
+
+    const std::optional<double> timeLimit = request.has("time_limit")
+        ? std::optional<double>(parseSeconds(request.field("time_limit")))
+        : config.render.timeLimitSeconds;
+    lane.cancellation.reset();
+    if (m_stopping.load(std::memory_order_relaxed)) {
+        throw std::runtime_error("Daemon is stopping");
+    }
+    if (timeLimit) {
+        lane.cancellation.setDeadline(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(*timeLimit)));
+    }
+
+    rayscene::Scene scene(config);
+    const Clock::time_point renderStart = Clock::now();
+    if (m_renderMetrics) {
+        m_renderMetrics->observeStage("load", std::chrono::duration<double>(renderStart - start).count());
+    }
+
+    // Les animations passent par le cache image par image (RenderAnimation).
+    const std::string cacheKey = m_options.cache && !config.animation ? rayapp::RenderCacheKey(config, frameOptions) : std::string();
+    std::vector<unsigned char> cachedPng;
+
+    Message reply;
+    reply.command = "OK";
+    rayapp::FrameStatus status{};
+    if (!cacheKey.empty() && (replyKind == "file" ? m_options.cache->fetch(cacheKey, config.outputPath)
+                                                  : m_options.cache->fetch(cacheKey, cachedPng))) {
+        status = rayapp::FrameStatus{config.echantillonsNumber, true};
+        reply.fields["cached"] = "1";
+        if (replyKind == "file") {
+            reply.fields["output"] = config.outputPath;
+        } else {
+            reply.payload.assign(cachedPng.begin(), cachedPng.end());
+        }
+    } else if (config.animation) {
+        rayapp::AnimationOptions animationOptions;
+        animationOptions.frame = frameOptions;
+        animationOptions.frameTimeLimitSeconds = timeLimit;
+        animationOptions.cache = m_options.cache;
+        rayapp::AnimationReport animation;
+        std::ostringstream frames;  // Lignes par image : le journal du démon n'en garde qu'une par job
+        rayapp::RenderAnimation(config, scene, renderer, lane.pipeline, lane.cancellation, animationOptions, animation, frames);
+        lane.pipeline.wait();
+        if (!animation.error.empty()) {
+            throw std::runtime_error(animation.error);
+        }
+        status = rayapp::FrameStatus{animation.minSamplesPerPixel, animation.incompleteFrames == 0};
+        reply.fields["frames"] = std::to_string(animation.frames);
+        reply.fields["output"] = config.animation->outputPattern;
+    } else if (replyKind == "file") {
+        // Même chemin que la ligne de commande : PNG encodé pendant le rendu, encodeurs réutilisés.
+        Image& image = lane.pipeline.begin(config, renderer);
+        try {
+            status = rayapp::RenderFrameInto(image, config, scene, renderer, frameOptions);
+        } catch (...) {
+            lane.pipeline.abandon(renderer);
+            throw;
+        }
+        std::string encodeError;
+        lane.pipeline.end(renderer, [&encodeError](double, std::exception_ptr error) {
+            if (!error) return;
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                encodeError = e.what();
+            }
+        });
+        lane.pipeline.wait();  // Le client lit le fichier dès la réponse
+        if (!encodeError.empty()) {
+            throw std::runtime_error(encodeError);
+        }
+        if (!cacheKey.empty() && status.complete) {
+            m_options.cache->store(cacheKey, config.outputPath);
+        }
+        reply.fields["output"] = config.outputPath;
+    } else {
+        Image image = rayapp::MakeFrameImage(config, renderer);
+        status = rayapp::RenderFrameInto(image, config, scene, renderer, frameOptions);
+        const Clock::time_point encodeStart = Clock::now();
+        const std::vector<unsigned char> png = image.EncodePNG();
+        reply.payload.assign(png.begin(), png.end());
+        if (!cacheKey.empty() && status.complete) {
+            m_options.cache->store(cacheKey, png);
+        }
+        if (m_renderMetrics) {
+            m_renderMetrics->frameRendered(std::chrono::duration<double>(encodeStart - renderStart).count());
+            m_renderMetrics->frameEncoded(std::chrono::duration<double>(Clock::now() - encodeStart).count());
+        }
+    }
+
+    const double renderSeconds = std::chrono::duration<double>(Clock::now() - renderStart).count();
+    const double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    reply.fields["width"] = std::to_string(config.width);
+    reply.fields["height"] = std::to_string(config.height);
+    reply.fields["samples"] = std::to_string(status.samplesPerPixel);
+    reply.fields["complete"] = status.complete ? "1" : "0";
+    reply.fields["render_ms"] = formatMs(renderSeconds);
+    reply.fields["total_ms"] = formatMs(totalSeconds);
+    if (m_renderMetrics) {
+        m_renderMetrics->observeStage("render", renderSeconds);
+        m_renderMetrics->observeStage("job", totalSeconds);
+    }
+    reply.fields["wait_ms"] = formatMs(job.waitSeconds);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        reply.fields["paused_ms"] = formatMs(job.pausedSeconds);
+    }
+
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log << "Rendered " << (source == "path" ? request.payload : std::string("<inline scene>"))
+          << " (" << config.width << "x" << config.height << ", " << JobPriorityName(job.priority) << " priority, "
+          << "waited " << reply.fields["wait_ms"] << " ms, " << reply.fields["total_ms"] << " ms"
+          << (status.complete ? "" : ", time limit") << (reply.has("cached") ? ", cached" : "") << ")" << std::endl;
+    return reply;
+}
+
+} // namespace rayserver
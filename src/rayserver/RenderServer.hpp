@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Protocol.hpp"
+
+#include "../rayapp/FramePipeline.hpp"
+#include "../rayapp/RenderCache.hpp"
+#include "../rayapp/RenderMetrics.hpp"
+#include "../rayrender/CancellationToken.hpp"
+#include "../rayrender/TileGate.hpp"
+#include "../rayrender/TileRenderer.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace rayserver {
+
+enum class JobPriority { Low = 0, Normal = 1, High = 2 };
+constexpr std::size_t JobPriorityCount = 3;
+
+// "low", "normal" ou "high" ; lève std::invalid_argument sinon.
+JobPriority ParseJobPriority(const std::string& text);
+const char* JobPriorityName(JobPriority priority) noexcept;
+
+struct ServerOptions {
+    std::string socketPath;
+    rayapp::FrameOptions frame;
+    // Registre des métriques (requête METRICS, fichier éventuel) ; doit survivre au serveur.
+    Metrics* metrics = nullptr;
+    // Cache des images déjà rendues (--cache) ; nullptr pour toujours rendre.
+    rayapp::RenderCache* cache = nullptr;
+};
+
+// Attente dans la file (de l'arrivée au début du rendu) des jobs d'une priorité.
+struct WaitStats {
+    std::uint64_t jobs = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+};
+
+// Compteurs du démon depuis son démarrage, plus l'état courant de la file.
+struct ServerStats {
+    std::array<std::size_t, JobPriorityCount> queued{};  // Jobs en attente, par priorité
+    std::size_t running = 0;
+    std::uint64_t completed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t preemptions = 0;
+    std::array<WaitStats, JobPriorityCount> wait{};
+};
+
+// Démon de rendu : écoute sur une socket Unix et rend les scènes reçues avec des workers
+// créés une seule fois (tampons d'encodage réutilisés).
+// Un thread par connexion lit les requêtes et les range dans une file par priorité, puis par arrivée.
+// Deux voies de rendu : la voie principale prend la tête de la file ; si un job plus prioritaire
+// que le sien arrive, la voie de préemption le rend sur son propre pool (mêmes CPU) pendant que
+// les workers de la voie principale attendent à la tuile suivante, puis le job suspendu reprend.
+class RenderServer {
+public:
+    RenderServer(rayrender::TileRenderer& renderer, ServerOptions options, std::ostream& log);
+    ~RenderServer();
+
+    RenderServer(const RenderServer&) = delete;
+    RenderServer& operator=(const RenderServer&) = delete;
+
+    // Ouvre la socket et sert les requêtes jusqu'à stop() ou une requête SHUTDOWN.
+    void run();
+
+    // Demande l'arrêt ; utilisable depuis un gestionnaire de signal.
+    void stop() noexcept;
+
+    ServerStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        Message request;
+        JobPriority priority = JobPriority::Normal;
+        Clock::time_point enqueued;
+        double waitSeconds = 0.0;     // De l'arrivée au début du rendu
+        double pausedSeconds = 0.0;   // Temps passé suspendu par des jobs plus prioritaires
+        std::promise<Message> reply;
+    };
+
+    struct Lane {
+        const char* name = "";
+        rayrender::TileRenderer* renderer = nullptr;
+        rayrender::CancellationToken cancellation;
+        rayapp::FramePipeline pipeline;
+        std::thread thread;
+        Job* current = nullptr;
+    };
+
+    void serveConnection(int fd);
+    void laneLoop(Lane& lane);
+    bool canStart(const Lane& lane) const;  // Sous m_mutex
+    Message render(Lane& lane, Job& job);
+
+    ServerOptions m_options;
+    std::ostream& m_log;
+    std::optional<rayapp::RenderMetrics> m_renderMetrics;
+    std::array<Histogram*, JobPriorityCount> m_waitHistograms{};
+    std::unique_ptr<rayrender::TileRenderer> m_preemptRenderer;
+    rayrender::TileGate m_gate;            // Fermée pendant une préemption de la voie principale
+    Lane m_main;
+    Lane m_preempt;
+    Clock::time_point m_pauseStart;
+
+    std::atomic<bool> m_stopping{false};
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;     // File ou voies modifiées
+    std::deque<Job*> m_jobs;               // Par priorité décroissante, puis par arrivée
+    ServerStats m_stats;
+    std::set<int> m_connections;           // Sockets ouvertes, coupées à l'arrêt pour débloquer leurs threads
+    std::condition_variable m_connectionsDone;
+    std::mutex m_logMutex;
+};
+
+} // namespace rayserver
@@ -1,14 +1,15 @@
 #include "DiffuseShader.hpp"
 #include "../raymath/Color.hpp"
 #include "../rayscene/Light.hpp"
-#include "../rayscene/Sphere.hpp"
+#include "../rayscene/SphereBvh.hpp"
 #include "../raymath/Ray.hpp"
 #include "../raymath/Intersection.hpp"
+#include "../rayrender/RenderStats.hpp"
 #include <vector>
 
 using namespace math;
 
-float DiffuseShader::Shade(math::HitInfo hitInfo, Light light, const std::vector<rayscene::Sphere>& spheres, Vec3 camera, int specularPower) {
+float DiffuseShader::Shade(math::HitInfo hitInfo, Light light, const rayscene::SphereBvh& spheres, Vec3 camera, int specularPower) {
     // TODO make ambientFactor a global variable
     float ambientFactor = 0.3f;
 
@@ -16,15 +17,15 @@ float DiffuseShader::Shade(math::HitInfo hitInfo, Light light, const std::vector
 
     Vec3 lightPos = light.getPosition();
     Vec3 lightVector = Vec3(lightPos.x - hitInfo.point.x, lightPos.y - hitInfo.point.y, lightPos.z - hitInfo.point.z);
+    float distanceToLight = lightVector.length();
     Vec3 lightDir = lightVector.normalize();
 
     Ray shadowRay(hitInfo.point, lightDir);
+    rayrender::stats::CountRay(rayrender::RayKind::Shadow);
 
-    for (const auto& sphere : spheres) {
-        const auto hit = sphere.intersect(shadowRay);
-        if (hit) {
-            return ambientFactor;
-        }
+    // Une sphère au-delà de la lumière ne fait pas d'ombre
+    if (spheres.occluded(shadowRay, distanceToLight)) {
+        return ambientFactor;
     }
 
     float dotProduct = normal.x * lightDir.x + normal.y * lightDir.y + normal.z * lightDir.z;
@@ -47,7 +48,7 @@ float DiffuseShader::Shade(math::HitInfo hitInfo, Light light, const std::vector
     return ambientFactor + diffuse + specular;
 }
 
-float DiffuseShader::ShadowFactorPlane(math::HitInfo hitInfo, Light light, const std::vector<rayscene::Sphere>& spheres) {
+float DiffuseShader::ShadowFactorPlane(math::HitInfo hitInfo, Light light, const rayscene::SphereBvh& spheres) {
     float ambientFactor = 0.3f;
 
     Vec3 planeNormal(0, 1, 0);
@@ -61,12 +62,10 @@ float DiffuseShader::ShadowFactorPlane(math::HitInfo hitInfo, Light light, const
     Vec3 lightDir = lightVector.normalize();
 
     Ray shadowRay(hitInfo.point, lightDir);
+    rayrender::stats::CountRay(rayrender::RayKind::Shadow);
 
-    for (const auto& sphere : spheres) {
-        const auto hit = sphere.intersect(shadowRay);
-        if (hit && hit->t < distanceToLight) {
-            return ambientFactor;
-        }
+    if (spheres.occluded(shadowRay, distanceToLight)) {
+        return ambientFactor;
     }
 
     float dotProduct = planeNormal.x * lightDir.x + planeNormal.y * lightDir.y + planeNormal.z * lightDir.z;
@@ -3,7 +3,7 @@
 #include <vector>
 #include "../raymath/Color.hpp"
 #include "../rayscene/Light.hpp"
-#include "../rayscene/Sphere.hpp"
+#include "../rayscene/SphereBvh.hpp"
 #include "../raymath/Intersection.hpp"
 
 using namespace std;
@@ -12,7 +12,7 @@ class DiffuseShader {
     private:
 
     public:
-        float Shade(math::HitInfo hitInfo, Light light, const std::vector<rayscene::Sphere>& spheres, Vec3 camera, int specularPower);
+        float Shade(math::HitInfo hitInfo, Light light, const rayscene::SphereBvh& spheres, Vec3 camera, int specularPower);
 
-        float ShadowFactorPlane(math::HitInfo hitInfo, Light light, const std::vector<rayscene::Sphere>& spheres);
+        float ShadowFactorPlane(math::HitInfo hitInfo, Light light, const rayscene::SphereBvh& spheres);
 };
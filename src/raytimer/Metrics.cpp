@@ -0,0 +1,232 @@
+#include "Metrics.hpp"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+namespace {
+
+// Nombres au format Prometheus : 12 chiffres significatifs, +Inf pour l'infini.
+std::string formatValue(double value) {
+    if (value == std::numeric_limits<double>::infinity()) {
+        return "+Inf";
+    }
+    std::ostringstream text;
+    text.precision(12);
+    text << value;
+    return text.str();
+}
+
+std::string withLabels(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) {
+        return "";
+    }
+    return "{" + labels + (labels.empty() || extra.empty() ? "" : ",") + extra + "}";
+}
+
+double processCpuSeconds() {
+    timespec cpu{};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    return static_cast<double>(cpu.tv_sec) + static_cast<double>(cpu.tv_nsec) * 1e-9;
+}
+
+// Deuxième champ de /proc/self/statm : pages résidentes.
+double residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0.0;
+    }
+    return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
+void MetricValue::add(double delta) noexcept {
+    double value = m_value.load(std::memory_order_relaxed);
+    while (!m_value.compare_exchange_weak(value, value + delta, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Histogram(std::vector<double> bounds)
+    : m_bounds(std::move(bounds))
+    , m_buckets(new std::atomic<std::uint64_t>[m_bounds.size() + 1]) {
+    for (std::size_t i = 0; i <= m_bounds.size(); ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) noexcept {
+    std::size_t index = 0;
+    while (index < m_bounds.size() && value > m_bounds[index]) {
+        ++index;
+    }
+    m_buckets[index].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.add(value);
+}
+
+std::uint64_t Histogram::bucket(std::size_t index) const noexcept {
+    return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+std::vector<double> LatencyBounds() {
+    return {0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0, 300.0};
+}
+
+Metrics::Family& Metrics::family(const std::string& name, const std::string& help, const char* type) {
+    Family& entry = m_families[name];
+    if (entry.type.empty()) {
+        entry.help = help;
+        entry.type = type;
+    } else if (entry.type != type) {
+        throw std::logic_error("Metric " + name + " is already a " + entry.type);
+    }
+    return entry;
+}
+
+MetricValue& Metrics::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<MetricValue>& value = family(name, help, "counter").values[labels];
+    if (!value) value = std::make_unique<MetricValue>();
+    return *value;
+}
+
+MetricValue& Metrics::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<MetricValue>& value = family(name, help, "gauge").values[labels];
+    if (!value) value = std::make_unique<MetricValue>();
+    return *value;
+}
+
+Histogram& Metrics::histogram(const std::string& name, const std::string& help, const std::string& labels,
+                              std::vector<double> bounds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_ptr<Histogram>& histogram = family(name, help, "histogram").histograms[labels];
+    if (!histogram) histogram = std::make_unique<Histogram>(std::move(bounds));
+    return *histogram;
+}
+
+void Metrics::addCollector(std::function<void()> collect) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_collectors.push_back(std::move(collect));
+}
+
+void Metrics::write(std::ostream& out) {
+    // Deux écritures à la fois (fichier et requête) feraient tourner les collecteurs en parallèle.
+    std::lock_guard<std::mutex> writing(m_writeMutex);
+    std::vector<std::function<void()>> collectors;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectors = m_collectors;
+    }
+    // Hors verrou : un collecteur peut enregistrer de nouvelles valeurs.
+    for (const std::function<void()>& collect : collectors) {
+        collect();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& [name, entry] : m_families) {
+        out << "# HELP " << name << " " << entry.help << "\n"
+            << "# TYPE " << name << " " << entry.type << "\n";
+        for (const auto& [labels, value] : entry.values) {
+            out << name << withLabels(labels) << " " << formatValue(value->get()) << "\n";
+        }
+        for (const auto& [labels, histogram] : entry.histograms) {
+            std::uint64_t cumulative = 0;
+            const std::vector<double>& bounds = histogram->bounds();
+            for (std::size_t i = 0; i <= bounds.size(); ++i) {
+                cumulative += histogram->bucket(i);
+                const double bound = i < bounds.size() ? bounds[i] : std::numeric_limits<double>::infinity();
+                out << name << "_bucket" << withLabels(labels, "le=\"" + formatValue(bound) + "\"") << " " << cumulative << "\n";
+            }
+            out << name << "_sum" << withLabels(labels) << " " << formatValue(histogram->sum()) << "\n"
+                << name << "_count" << withLabels(labels) << " " << histogram->count() << "\n";
+        }
+    }
+}
+
+void AddProcessMetrics(Metrics& metrics, unsigned threads) {
+    using Clock = std::chrono::steady_clock;
+    MetricValue& resident = metrics.gauge("hetic_process_resident_memory_bytes", "Resident set size.");
+    MetricValue& cpu = metrics.counter("hetic_process_cpu_seconds_total", "User and system CPU time of the process.");
+    MetricValue& uptime = metrics.gauge("hetic_process_uptime_seconds", "Time since the metrics were set up.");
+    MetricValue& threadCount = metrics.gauge("hetic_render_threads", "Render worker threads.");
+    MetricValue& utilization = metrics.gauge("hetic_thread_utilization",
+        "CPU time over wall time times render threads, since the previous scrape (0 to 1).");
+    threadCount.set(threads);
+
+    struct Previous {
+        Clock::time_point start = Clock::now();
+        Clock::time_point wall = start;
+        double cpu = processCpuSeconds();
+    };
+    auto previous = std::make_shared<Previous>();
+    metrics.addCollector([=, &resident, &cpu, &uptime, &utilization] {
+        const Clock::time_point now = Clock::now();
+        const double cpuNow = processCpuSeconds();
+        const double wall = std::chrono::duration<double>(now - previous->wall).count();
+        if (wall > 0.0 && threads > 0) {
+            utilization.set((cpuNow - previous->cpu) / (wall * threads));
+        }
+        previous->wall = now;
+        previous->cpu = cpuNow;
+        resident.set(residentBytes());
+        cpu.set(cpuNow);
+        uptime.set(std::chrono::duration<double>(now - previous->start).count());
+    });
+}
+
+MetricsFile::MetricsFile(Metrics& metrics, std::string path, std::chrono::milliseconds interval)
+    : m_metrics(metrics)
+    , m_path(std::move(path))
+    , m_interval(interval)
+    , m_thread([this] { run(); }) {}
+
+MetricsFile::~MetricsFile() {
+    stop();
+}
+
+void MetricsFile::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_wake.wait_for(lock, m_interval, [this] { return !m_running; });
+        if (!m_running) break;
+        lock.unlock();
+        writeNow();
+        lock.lock();
+    }
+}
+
+void MetricsFile::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) return;
+        m_running = false;
+    }
+    m_wake.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+    writeNow();
+}
+
+void MetricsFile::writeNow() {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    const std::string temporary = m_path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        m_metrics.write(out);
+        if (!out.flush()) {
+            std::remove(temporary.c_str());
+            return;  // Disque plein ou dossier absent : on réessaiera à la prochaine période
+        }
+    }
+    std::rename(temporary.c_str(), m_path.c_str());
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Valeur d'un compteur ou d'une jauge ; lue et écrite sans verrou.
+class MetricValue {
+public:
+    void set(double value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+    void add(double delta) noexcept;
+    double get() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+// Histogramme à bornes fixes (en secondes pour les latences) ; observe() sans verrou.
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void observe(double value) noexcept;
+
+    const std::vector<double>& bounds() const noexcept { return m_bounds; }
+    std::uint64_t bucket(std::size_t index) const noexcept;  // Non cumulé ; index == bounds().size() : au-delà
+    std::uint64_t count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+    double sum() const noexcept { return m_sum.get(); }
+
+private:
+    std::vector<double> m_bounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets;
+    std::atomic<std::uint64_t> m_count{0};
+    MetricValue m_sum;
+};
+
+// Bornes par défaut des latences : de 1 ms à 5 min.
+std::vector<double> LatencyBounds();
+
+// Registre de métriques écrit au format texte de Prometheus.
+// L'enregistrement prend un verrou ; les références rendues restent valides et se mettent à jour sans verrou.
+// Une même paire (nom, labels) rend toujours la même valeur. Les labels s'écrivent `clé="valeur",...`.
+class Metrics {
+public:
+    MetricValue& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    MetricValue& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "",
+                         std::vector<double> bounds = LatencyBounds());
+
+    // Appelé au début de chaque write() : met à jour les valeurs calculées (débits, mémoire...).
+    void addCollector(std::function<void()> collect);
+
+    void write(std::ostream& out);
+
+private:
+    struct Family {
+        std::string help;
+        std::string type;
+        std::map<std::string, std::unique_ptr<MetricValue>> values;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, const std::string& help, const char* type);
+
+    std::mutex m_writeMutex;
+    std::mutex m_mutex;
+    std::map<std::string, Family> m_families;
+    std::vector<std::function<void()>> m_collectors;
+};
+
+// Métriques du processus : mémoire résidente, temps CPU, durée de vie, et occupation des
+// `threads` threads de rendu (temps CPU rapporté au temps écoulé depuis la dernière écriture).
+void AddProcessMetrics(Metrics& metrics, unsigned threads);
+
+// Réécrit un fichier de métriques à intervalle régulier (format textfile de node_exporter).
+// Fichier temporaire puis rename() : un lecteur ne voit jamais un fichier à moitié écrit.
+// Même mécanique que Timer : un thread réveillé chaque période, ou tout de suite à l'arrêt.
+class MetricsFile {
+public:
+    MetricsFile(Metrics& metrics, std::string path, std::chrono::milliseconds interval = std::chrono::seconds(5));
+    ~MetricsFile();  // Dernière écriture, valeurs finales comprises
+
+    void stop();
+    void writeNow();
+
+private:
+    void run();
+
+    Metrics& m_metrics;
+    std::string m_path;
+    std::chrono::milliseconds m_interval;
+    bool m_running = true;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::mutex m_writeMutex;
+    std::thread m_thread;
+};
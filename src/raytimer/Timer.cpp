@@ -6,6 +6,7 @@ Timer::Timer (std :: string label):
          label_(std::move(label)),
          running_(true),
          start_(std ::chrono::steady_clock::now()),
+         deadline_(std::chrono::steady_clock::time_point::max()),
          t_([this]{ run(); }) {}
 
 
@@ -16,11 +17,15 @@ void Timer::run() {
     using namespace std::chrono;
     const char spin[4] = {'|','/','-','\\'};
     size_t i = 0;
+    std::unique_lock<std::mutex> lock(m_);
     while (running_) {
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        wake_.wait_for(lock, seconds(1), [this] { return !running_; });
+        if (!running_) break;
         const auto s = duration_cast<seconds>(steady_clock::now() - start_).count();
         std::cout << "\r" << label_ << " " << spin[i++ % 4]
-                  << "  Temps ecoule : " << s << " s" << std::flush;
+                  << "  Temps ecoule : " << s << " s";
+        if (progress_) std::cout << "  " << progress_();
+        std::cout << std::flush;
     }
 }
 
@@ -32,6 +37,10 @@ Timer::~Timer() { stop(); }
 // stop() :Demande l'arrêt (running_=false), rejoint le thread et affiche la durée totale
 void Timer::stop() {
     if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> lock(m_); // Synchronise avec run() pour ne pas perdre la notification
+        }
+        wake_.notify_all();
         if (t_.joinable()) t_.join();
         using namespace std::chrono;
         const auto ms = duration_cast<milliseconds>(steady_clock::now() - start_).count();
@@ -40,3 +49,30 @@ void Timer::stop() {
     }
 }
 
+
+
+// setTimeLimit() : l'échéance est fixée par rapport à start_, pas à l'appel
+void Timer::setTimeLimit(std::chrono::steady_clock::duration limit) {
+    deadline_ = start_ + limit;
+}
+
+bool Timer::hasDeadline() const {
+    return deadline_ != std::chrono::steady_clock::time_point::max();
+}
+
+std::chrono::steady_clock::time_point Timer::deadline() const {
+    return deadline_;
+}
+
+bool Timer::expired() const {
+    return hasDeadline() && std::chrono::steady_clock::now() >= deadline_;
+}
+
+std::chrono::steady_clock::time_point Timer::start() const {
+    return start_;
+}
+
+void Timer::setProgress(std::function<std::string()> progress) {
+    std::lock_guard<std::mutex> lock(m_);
+    progress_ = std::move(progress);
+}
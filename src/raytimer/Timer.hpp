@@ -1,8 +1,11 @@
 #pragma once
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -15,11 +18,27 @@ public:
 
     void stop();// Demande l'arrêt 
 
+    // Budget de temps compté depuis le démarrage du chronomètre.
+    void setTimeLimit(std::chrono::steady_clock::duration limit);
+    bool hasDeadline() const;
+    std::chrono::steady_clock::time_point deadline() const; // time_point::max() sans budget
+    bool expired() const;                                   // Échéance dépassée ?
+
+    std::chrono::steady_clock::time_point start() const;
+
+    // Texte ajouté à la ligne d'état chaque seconde (ex. : avancement lu dans les compteurs
+    // par thread). Appelé depuis le thread du Timer : il ne doit pas prendre de verrou du rendu.
+    void setProgress(std::function<std::string()> progress);
+
 private:
     void run(); // Boucle d'affichage périodique du temps écoulé depuis start_.
 
     std::string label_;
     std::atomic<bool> running_;
     std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::mutex m_;
+    std::condition_variable wake_; // Réveille run() dès l'arrêt, sans attendre la fin de la seconde
+    std::function<std::string()> progress_; // Protégé par m_ (jamais pris par les workers)
     std::thread t_;
 };
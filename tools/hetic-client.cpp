@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "Protocol.hpp"
+
+using namespace std;
+
+static void PrintUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--socket PATH] [--inline] [--seed N] [--time-limit SECONDS]\n"
+              << "           [--priority low|normal|high] [-o OUTPUT] scene.json|-\n"
+              << "       " << program << " [--socket PATH] --ping|--stats|--metrics|--shutdown\n"
+              << "Without -o, the daemon writes the image to the scene's output path.\n"
+              << "With -o, the PNG comes back over the socket and is written to OUTPUT ('-' for stdout).\n"
+              << "'-' as scene reads the JSON from stdin (implies --inline)." << endl;
+}
+
+static std::string ReadAll(std::istream& input)
+{
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+int main(int argc, char* argv[])
+{
+    std::string socketPath = rayserver::DefaultSocketPath();
+    rayserver::Message request;
+    request.command = "RENDER";
+    std::string scenePath;
+    std::string outputPath;
+    bool sendInline = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue) {
+            socketPath = argv[++i];
+        } else if (arg == "--inline") {
+            sendInline = true;
+        } else if (arg == "--seed" && hasValue) {
+            request.fields["seed"] = argv[++i];
+        } else if (arg == "--time-limit" && hasValue) {
+            request.fields["time_limit"] = argv[++i];
+        } else if (arg == "--priority" && hasValue) {
+            request.fields["priority"] = argv[++i];
+        } else if (arg == "-o" && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--ping") {
+            request.command = "PING";
+        } else if (arg == "--metrics") {
+            request.command = "METRICS";
+        } else if (arg == "--stats") {
+            request.command = "STATS";
+        } else if (arg == "--shutdown") {
+            request.command = "SHUTDOWN";
+        } else if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (arg != "-" && !arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << endl;
+            PrintUsage(argv[0]);
+            return 1;
+        } else {
+            scenePath = arg;
+        }
+    }
+
+    if (request.command == "RENDER" && scenePath.empty()) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (request.command == "RENDER") {
+            if (scenePath == "-") {
+                request.fields["source"] = "json";
+                request.payload = ReadAll(std::cin);
+            } else if (sendInline) {
+                std::ifstream input(scenePath, std::ios::binary);
+                if (!input) {
+                    throw std::runtime_error("Unable to open scene file: " + scenePath);
+                }
+                request.fields["source"] = "json";
+                request.payload = ReadAll(input);
+            } else {
+                // Le démon a son propre répertoire courant : on lui donne un chemin absolu.
+                request.fields["source"] = "path";
+                request.payload = std::filesystem::absolute(scenePath).string();
+            }
+            request.fields["reply"] = outputPath.empty() ? "file" : "png";
+        }
+
+        const rayserver::Message reply = rayserver::Call(socketPath, request);
+        if (reply.command != "OK") {
+            std::cerr << "Daemon error: " << reply.payload << endl;
+            return 1;
+        }
+
+        if (request.command == "PING") {
+            std::cout << "Daemon is up (" << reply.field("threads") << " render threads)" << endl;
+        } else if (request.command == "METRICS") {
+            std::cout << reply.payload;
+        } else if (request.command == "STATS") {
+            for (const auto& [key, value] : reply.fields) {
+                std::cout << key << " " << value << "\n";
+            }
+        } else if (request.command == "SHUTDOWN") {
+            std::cout << "Daemon is stopping" << endl;
+        } else {
+            std::string written = reply.field("output");
+            if (!outputPath.empty()) {
+                if (outputPath == "-") {
+                    std::cout.write(reply.payload.data(), static_cast<std::streamsize>(reply.payload.size()));
+                    return 0;
+                }
+                std::ofstream output(outputPath, std::ios::binary);
+                if (!output.write(reply.payload.data(), static_cast<std::streamsize>(reply.payload.size()))) {
+                    throw std::runtime_error("Unable to write " + outputPath);
+                }
+                written = outputPath;
+            }
+            std::cerr << written << " (" << reply.field("width") << "x" << reply.field("height")
+                      << ", " << reply.field("samples") << " spp" << (reply.field("complete") == "1" ? "" : ", time limit")
+                      << (reply.has("frames") ? ", " + reply.field("frames") + " frames" : std::string())
+                      << (reply.has("cached") ? ", from cache" : "")
+                      << ", waited " << reply.field("wait_ms") << " ms"
+                      << (reply.field("paused_ms", "0.0") != "0.0" ? ", paused " + reply.field("paused_ms") + " ms" : std::string())
+                      << ", render " << reply.field("render_ms") << " ms, total " << reply.field("total_ms") << " ms)" << endl;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Image.hpp"
+#include "Shard.hpp"
+
+using namespace std;
+
+static void PrintUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " OUTPUT.png SHARD_FILE...\n"
+              << "       " << program << " OUTPUT.png --shards N   (reads OUTPUT.png.shard-1-of-N ... N-of-N)" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    std::vector<std::string> shardPaths;
+
+    if (std::string(argv[2]) == "--shards") {
+        char* end = nullptr;
+        const long count = argc == 4 ? std::strtol(argv[3], &end, 10) : 0;
+        if (argc != 4 || *end != '\0' || count <= 0) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        for (long k = 0; k < count; ++k) {
+            shardPaths.push_back(rayapp::ShardPath(outputPath, rayapp::ShardSpec{static_cast<unsigned>(k), static_cast<unsigned>(count)}));
+        }
+    } else {
+        shardPaths.assign(argv + 2, argv + argc);
+    }
+
+    try {
+        Image image = rayapp::MergeShards(shardPaths);
+        image.WriteFile(outputPath.c_str());
+        std::cout << "Merged " << shardPaths.size() << " shard(s) into " << outputPath
+                  << " (" << image.Width() << "x" << image.Height() << ")" << endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
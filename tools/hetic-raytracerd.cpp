@@ -0,0 +1,130 @@
+#include <chrono>
+#include <csignal>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include "Executor.hpp"
+#include "RenderCache.hpp"
+#include "Metrics.hpp"
+#include "RenderServer.hpp"
+#include "TileRenderer.hpp"
+#include "Topology.hpp"
+
+using namespace std;
+
+static rayserver::RenderServer* g_server = nullptr;
+
+static void HandleSignal(int)
+{
+    if (g_server) g_server->stop();
+}
+
+static void PrintUsage(const char* program)
+{
+    std::cerr << "Usage: " << program << " [--socket PATH] [--executor serial|pool|par_unseq] [--threads N]"
+              << " [--affinity none|compact|scatter] [--two-pass] [--sample-parallel]"
+              << " [--metrics-file PATH [--metrics-interval SECONDS]] [--cache DIR [--cache-size MB]]\n"
+              << "Default socket: " << rayserver::DefaultSocketPath() << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    rayserver::ServerOptions options;
+    rayrender::RenderSettings renderSettings;
+    std::optional<std::string> metricsPath;
+    std::optional<std::string> cacheDirectory;
+    std::uint64_t cacheMegabytes = 1024;
+    std::chrono::milliseconds metricsInterval = std::chrono::seconds(5);
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--socket" && hasValue) {
+                options.socketPath = argv[++i];
+            } else if (arg == "--threads" && hasValue) {
+                char* end = nullptr;
+                const long threads = std::strtol(argv[++i], &end, 10);
+                if (*end != '\0' || threads <= 0) {
+                    throw std::invalid_argument(std::string("Expected a positive integer, got: ") + argv[i]);
+                }
+                renderSettings.threads = static_cast<unsigned>(threads);
+            } else if (arg == "--affinity" && hasValue) {
+                renderSettings.affinity = rayrender::ParseAffinityMode(argv[++i]);
+            } else if (arg == "--executor" && hasValue) {
+                renderSettings.executor = rayrender::ParseExecutorKind(argv[++i]);
+            } else if (arg == "--metrics-file" && hasValue) {
+                metricsPath = argv[++i];
+            } else if (arg == "--metrics-interval" && hasValue) {
+                char* end = nullptr;
+                const double seconds = std::strtod(argv[++i], &end);
+                if (*end != '\0' || !(seconds > 0)) {
+                    throw std::invalid_argument(std::string("Invalid metrics interval: ") + argv[i]);
+                }
+                metricsInterval = std::chrono::milliseconds(std::max<long long>(1, static_cast<long long>(seconds * 1000.0)));
+            } else if (arg == "--cache" && hasValue) {
+                cacheDirectory = argv[++i];
+            } else if (arg == "--cache-size" && hasValue) {
+                char* end = nullptr;
+                const long megabytes = std::strtol(argv[++i], &end, 10);
+                if (*end != '\0' || megabytes <= 0) {
+                    throw std::invalid_argument(std::string("Expected a positive integer, got: ") + argv[i]);
+                }
+                cacheMegabytes = static_cast<std::uint64_t>(megabytes);
+            } else if (arg == "--two-pass") {
+                options.frame.twoPass = true;
+            } else if (arg == "--sample-parallel") {
+                options.frame.sampleParallel = true;
+            } else if (arg == "--help" || arg == "-h") {
+                PrintUsage(argv[0]);
+                return 0;
+            } else {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+    } catch (const std::invalid_argument& error) {
+        std::cerr << error.what() << endl;
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        // Workers créés une fois pour toutes les requêtes.
+        rayrender::TileRenderer renderer(renderSettings);
+        rayrender::PrintTopology(std::cout, renderer.topology(), renderSettings.affinity, renderer.workerCpus());
+        std::cout << "Executor: " << rayrender::ExecutorKindName(renderer.executorKind())
+                  << ", render threads: " << renderer.threadCount() << endl;
+
+        // Toujours collectées (requête METRICS) ; écrites dans un fichier avec --metrics-file.
+        // Ordre de destruction : fichier (dernière écriture), serveur, puis registre.
+        Metrics metrics;
+        AddProcessMetrics(metrics, renderer.threadCount());
+        options.metrics = &metrics;
+        std::optional<rayapp::RenderCache> cache;
+        if (cacheDirectory) {
+            cache.emplace(*cacheDirectory, cacheMegabytes * 1024 * 1024);
+            options.cache = &*cache;
+        }
+        rayserver::RenderServer server(renderer, options, std::cout);
+        std::optional<MetricsFile> metricsFile;
+        if (metricsPath) {
+            metricsFile.emplace(metrics, *metricsPath, metricsInterval);
+        }
+        g_server = &server;
+        std::signal(SIGINT, HandleSignal);
+        std::signal(SIGTERM, HandleSignal);
+        server.run();
+        g_server = nullptr;
+        std::cout << "Stopped" << endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}